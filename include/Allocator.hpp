@@ -1,5 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan_format_traits.hpp>
 #include <vulkan/vulkan_raii.hpp>
 
 #include "Command.hpp"
@@ -11,6 +16,7 @@
 #include "Instance.hpp"
 #include "PhysicalDevice.hpp"
 #include "Sync.hpp"
+#include "UploadQueue.hpp"
 
 struct Allocator {
     Allocator(
@@ -42,14 +48,10 @@ struct Allocator {
 
     void destroyBuffer(Buffer buffer) const;
 
-    template <typename T>
-    [[nodiscard]]
-    auto createStagingBuffer(const std::vector<T> &vectorData) -> Buffer;
-
     template <typename T>
     [[nodiscard]]
     auto createBufferAndUploadData(
-        Command              &cmd,
+        UploadQueue          &uploads,
         const std::vector<T> &vectorData,
         vk::BufferUsageFlags2 usageFlags) -> Buffer;
 
@@ -61,10 +63,10 @@ struct Allocator {
     template <typename T>
     [[nodiscard]]
     auto createImageAndUploadData(
-        Command              &cmd,
-        const std::vector<T> &vectorData,
-        vk::ImageCreateInfo   imageInfo,
-        vk::ImageLayout       finalLayout) -> Image;
+        UploadQueue        &uploads,
+        std::span<const T>  imageData,
+        vk::ImageCreateInfo imageInfo,
+        vk::ImageLayout     finalLayout) -> Image;
 
     void freeStagingBuffers();
     void freeBuffers();
@@ -96,15 +98,13 @@ struct Allocator {
 template <typename T>
 [[nodiscard]]
 auto Allocator::createImageAndUploadData(
-    Command              &cmd,
-    const std::vector<T> &vectorData,
-    vk::ImageCreateInfo   imageInfo,
-    vk::ImageLayout       finalLayout) -> Image
+    UploadQueue        &uploads,
+    std::span<const T>  imageData,
+    vk::ImageCreateInfo imageInfo,
+    vk::ImageLayout     finalLayout) -> Image
 {
     assert(finalLayout == vk::ImageLayout::eShaderReadOnlyOptimal);
 
-    Buffer staging = createStagingBuffer(vectorData);
-
     imageInfo.setUsage(imageInfo.usage | vk::ImageUsageFlagBits::eTransferDst);
 
     Image image = createImage(imageInfo);
@@ -116,77 +116,57 @@ auto Allocator::createImageAndUploadData(
         0,
         imageInfo.arrayLayers};
 
-    cmdBarrierUndefinedToTransferDst(cmd.buffer, image.image, range);
+    cmdBarrierUndefinedToTransferDst(uploads.cmd(), image.image, range);
 
-    cmd.buffer.copyBufferToImage(
-        staging.buffer,
-        image.image,
-        vk::ImageLayout::eTransferDstOptimal,
-        vk::BufferImageCopy{
-            {},
-            {},
-            {},
-            vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, 0, 0, 1},
-            {},
-            imageInfo.extent});
+    const auto     blockExtent = vk::blockExtent(imageInfo.format);
+    const uint32_t blockSize   = vk::blockSize(imageInfo.format);
+
+    // imageData holds every mip level, tightly packed, level 0 first
+    const auto  data   = std::as_bytes(imageData);
+    std::size_t offset = 0u;
+
+    for (uint32_t level = 0u; level < imageInfo.mipLevels; ++level) {
+        const vk::Extent2D levelExtent{
+            std::max(imageInfo.extent.width >> level, 1u),
+            std::max(imageInfo.extent.height >> level, 1u)};
+
+        const std::size_t levelBytes =
+            std::size_t{(levelExtent.width + blockExtent[0] - 1u) / blockExtent[0]}
+            * ((levelExtent.height + blockExtent[1] - 1u) / blockExtent[1]) * blockSize;
+
+        uploads.uploadImage(
+            data.subspan(offset, levelBytes),
+            image.image,
+            vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, level, 0, 1},
+            levelExtent,
+            blockSize,
+            vk::Extent2D{blockExtent[0], blockExtent[1]});
+
+        offset += levelBytes;
+    }
 
-    cmdBarrierTransferDstToShaderReadOnly(cmd.buffer, image.image, range);
+    uploads.releaseImage(image.image, range);
 
     return image;
 }
 template <typename T>
 inline auto Allocator::createBufferAndUploadData(
-    Command              &cmd,
+    UploadQueue          &uploads,
     const std::vector<T> &vectorData,
     vk::BufferUsageFlags2 usageFlags) -> Buffer
 {
-    // fmt::print(stderr, "\n\ncalling createStagingBuffer()...\n\n");
-    // Create staging buffer and upload data
-    Buffer stagingBuffer = createStagingBuffer(vectorData);
-
-    // Create the final buffer in GPU memory
     const vk::DeviceSize bufferSize = sizeof(T) * vectorData.size();
 
-    // fmt::print(stderr, "\n\ncalling createBuffer()...\n\n");
+    // Create the final buffer in GPU memory
     Buffer buffer = createBuffer(
         bufferSize,
         usageFlags | vk::BufferUsageFlagBits2::eTransferDst,
+        false,
         VMA_MEMORY_USAGE_GPU_ONLY);
 
-    // fmt::print(stderr, "\n\ncalling cmd.copyBuffer()...\n\n");
-    cmd.buffer.copyBuffer(
-        stagingBuffer.buffer,
-        buffer.buffer,
-        vk::BufferCopy{}.setSize(bufferSize));
+    // streamed through the upload queue's staging ring
+    uploads.uploadBuffer(std::as_bytes(std::span{vectorData}), buffer.buffer);
+    uploads.releaseBuffer(buffer.buffer);
 
-    // fmt::print(stderr, "\n\nexiting...\n\n");
     return buffer;
 }
-
-template <typename T>
-inline auto Allocator::createStagingBuffer(const std::vector<T> &vectorData) -> Buffer
-{
-    const vk::DeviceSize bufferSize = sizeof(T) * vectorData.size();
-
-    // fmt::println(stderr, "size {}", vectorData.size() * sizeof(T));
-
-    // fmt::println(stderr, "calling createBuffer()...");
-    // Create a staging buffer
-    Buffer stagingBuffer = createBuffer(
-        bufferSize,
-        vk::BufferUsageFlagBits2::eTransferSrc,
-        true,
-        VMA_MEMORY_USAGE_CPU_TO_GPU,
-        VMA_ALLOCATION_CREATE_MAPPED_BIT
-            | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
-
-    // fmt::print(stderr, "\n\ncalling vmaCopyMemoryToAllocation()...\n\n");
-    vmaCopyMemoryToAllocation(
-        allocator.get(),
-        vectorData.data(),
-        stagingBuffer.allocation,
-        0,
-        bufferSize);
-
-    return stagingBuffer;
-}
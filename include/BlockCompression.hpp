@@ -0,0 +1,16 @@
+#pragma once
+
+#include "RenderAsset.hpp"
+
+// Block-compress the RGBA8 images of an asset, every mip level, in a format
+// chosen from how the materials sample each image:
+// - BC5 (RG) for images used only as normal maps; shaders rebuild z
+// - BC4 (R) for images read only through red (occlusion, clearcoat)
+// - BC7 for everything else, colour or packed data
+//
+// BC5 and BC4 images fall back to BC7 when formats lacks them; images whose
+// format the device cannot sample at all stay RGBA8. Images that are already
+// block-compressed or smaller than one block are left as they are. Blocks
+// are encoded on the worker pool; the output does not depend on the thread
+// count.
+auto compressTextures(RenderAsset &asset, const TextureFormatSupport &formats) -> void;
@@ -5,6 +5,7 @@
 #include <vulkan/vulkan.hpp>
 
 struct Buffer {
-    vk::Buffer    buffer{};
-    VmaAllocation allocation{};
+    vk::Buffer     buffer{};
+    VmaAllocation  allocation{};
+    vk::DeviceSize size = 0u; // as requested at creation
 };
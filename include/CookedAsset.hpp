@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "RenderAsset.hpp"
+
+// Versioned binary snapshot of a post-processed RenderAsset.
+//
+// A cooked file is a header, a fixed section table and 64-byte aligned
+// sections of plain records: vertex/index blobs, texture payloads,
+// materials, nodes, scenes and cameras. It also records the source files it
+// was produced from; their paths, sizes and write times hash to the stored
+// source stamp, so a stale cooked file is detected without parsing glTF.
+// The stamp is a make-style modification check, not a content hash.
+//
+// Vertex, index and texture payloads are not copied out of the file: the
+// returned asset views the mapping and keeps it alive (mappedStorage).
+
+// Bump whenever the cooked layout or the post-processing that feeds it
+// changes.
+inline constexpr std::uint32_t kCookedAssetVersion = 7u;
+
+// Default cooked file location for a glTF/GLB: "<source>.cooked" next to it.
+[[nodiscard]]
+auto defaultCookedAssetPath(const std::filesystem::path &gltfPath)
+    -> std::filesystem::path;
+
+// Read the cooked asset at cookedPath. Returns nullopt when the file is
+// missing, malformed, from another cooked version, or when its source files
+// (relative to sourceDirectory) or contentKey no longer match the stored
+// source stamp.
+[[nodiscard]]
+auto readCookedAsset(
+    const std::filesystem::path &cookedPath,
+    const std::filesystem::path &sourceDirectory,
+    std::uint64_t                contentKey) -> std::optional<RenderAsset>;
+
+// Write asset to cookedPath. sourceFiles are relative to sourceDirectory and
+// must list every file that contributed to asset; contentKey identifies the
+// load options that shaped it. Throws std::runtime_error on I/O failure.
+auto writeCookedAsset(
+    const std::filesystem::path              &cookedPath,
+    const std::filesystem::path              &sourceDirectory,
+    const std::vector<std::filesystem::path> &sourceFiles,
+    std::uint64_t                             contentKey,
+    const RenderAsset                        &asset) -> void;
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "Allocator.hpp"
+#include "Buffer.hpp"
+#include "DescriptorSources.hpp"
+#include "Device.hpp"
+#include "PipelineCache.hpp"
+#include "RenderTargets.hpp"
+#include "ShaderInterface.hpp"
+
+struct RenderableResources;
+
+// Which cull dispatch to record; see frustum_cull.slang.
+// - Frustum: frustum test only, into CullList::Main.
+// - Early: draws visible last frame that pass the frustum test, into
+//   CullList::Main.
+// - Late: draws that pass the frustum and depth pyramid tests and were not
+//   drawn early, into CullList::Late. Updates per-draw visibility.
+enum class CullPhase : uint32_t { Frustum = 0, Early = 1, Late = 2 };
+
+// Each frame owns one compacted command list per base pass.
+enum class CullList : uint32_t { Main = 0, Late = 1 };
+
+// GPU frustum and occlusion culling for indirect submission.
+//
+// A compute dispatch tests every draw's DrawBounds against the frustum of
+// FrameUniforms::viewProjectionMatrix and compacts the indirect commands of
+// visible draws into a per-frame buffer, together with their count, one
+// section per RasterStateGroup. The base pass then consumes each section
+// with drawIndexedIndirectCount.
+//
+// With occlusion culling the frame is split in two: the early list is drawn,
+// its depth is reduced to a Hi-Z pyramid, and the late phase tests the
+// remaining draws against that pyramid.
+struct CullPass {
+    CullPass(
+        Device                      &device,
+        const PipelineCache         &pipelineCache,
+        const std::filesystem::path &shaderPath,
+        uint32_t                     maxFramesInFlight,
+        bool                         occlusionCulling);
+
+    // (Re)create the per-frame visible command/count buffers and the
+    // per-draw visibility for drawCount draws.
+    auto initializePerFrameBuffers(
+        Allocator &allocator,
+        uint32_t   drawCount) -> void;
+
+    // depthPyramid may be null when occlusion culling is off. No-op when the
+    // frame's sets were already written with the same sources.
+    auto updateDescriptorSet(
+        Device                    &device,
+        uint32_t                   frameIndex,
+        const Buffer              &frameUBO,
+        const Buffer              &nodeInstancesSSBO,
+        const RenderableResources &renderableResources,
+        vk::ImageView              depthPyramid,
+        const DescriptorSources   &sources) -> void;
+
+    // Records the count reset, the cull dispatch and the barrier that makes
+    // the results visible to indirect draws. pyramid is read by the late
+    // phase only.
+    auto record(
+        vk::raii::CommandBuffer  &cmd,
+        uint32_t                  frameIndex,
+        uint32_t                  drawCount,
+        CullPhase                 phase,
+        const DepthPyramidTarget &pyramid) -> void;
+
+    [[nodiscard]]
+    auto visibleCommands(
+        uint32_t frameIndex,
+        CullList list) const -> const Buffer &;
+
+    [[nodiscard]]
+    auto visibleCount(
+        uint32_t frameIndex,
+        CullList list) const -> const Buffer &;
+
+  private:
+    static constexpr uint32_t kListCount = 2u;
+
+    ShaderInterface                      shaderInterface;
+    vk::raii::DescriptorPool             descriptorPool;
+    // kListCount sets per frame, indexed by listIndex()
+    std::vector<vk::raii::DescriptorSet> descriptorSets;
+    vk::raii::PipelineLayout             pipelineLayout;
+    vk::raii::Pipeline                   frustumPipeline;
+    // null unless occlusion culling is enabled
+    vk::raii::Pipeline                   earlyPipeline = nullptr;
+    vk::raii::Pipeline                   latePipeline  = nullptr;
+
+    std::vector<Buffer> visibleCommandsBuffers;
+    std::vector<Buffer> visibleCountBuffers;
+
+    // per frame: what its sets were last written with; reset whenever the
+    // buffers above are recreated
+    std::vector<DescriptorSources> describedSources;
+
+    // 1 per draw that passed the late test; shared by all frames, as frames
+    // run in submission order on one queue
+    Buffer drawVisibilityBuffer;
+    bool   drawVisibilityCleared = false;
+
+    [[nodiscard]]
+    static auto listIndex(
+        uint32_t frameIndex,
+        CullList list) -> std::size_t;
+
+    static auto createDescriptorPool(
+        Device  &device,
+        uint32_t maxFramesInFlight) -> vk::raii::DescriptorPool;
+
+    static auto createPipelineLayout(
+        Device                       &device,
+        const vk::DescriptorSetLayout setLayout) -> vk::raii::PipelineLayout;
+
+    static auto createPipeline(
+        Device                         &device,
+        const PipelineCache            &pipelineCache,
+        const std::filesystem::path    &shaderPath,
+        const char                     *entryPoint,
+        const vk::raii::PipelineLayout &pipelineLayout) -> vk::raii::Pipeline;
+};
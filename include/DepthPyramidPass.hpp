@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "Device.hpp"
+#include "PipelineCache.hpp"
+#include "RenderTargets.hpp"
+#include "ShaderInterface.hpp"
+
+// Builds a DepthPyramidTarget from a DepthTarget in compute, one dispatch
+// per level, each reducing the previous level (level 0 reduces the depth
+// buffer itself).
+struct DepthPyramidPass {
+    // Upper bound on pyramid levels (a 32768 texel wide level 0).
+    static constexpr uint32_t kMaxLevels = 16u;
+
+    DepthPyramidPass(
+        Device                      &device,
+        const PipelineCache         &pipelineCache,
+        const std::filesystem::path &shaderPath);
+
+    // Point the per-level descriptor sets at depth/pyramid. Cheap no-op while
+    // renderTargetsGeneration (RenderTargets::generation) is unchanged.
+    auto updateDescriptorSets(
+        Device                   &device,
+        const DepthTarget        &depth,
+        const DepthPyramidTarget &pyramid,
+        uint64_t                  renderTargetsGeneration) -> void;
+
+    // depth must be in kShaderSampledRead and pyramid in
+    // kComputeStorageReadWrite. Ends with the barrier that makes the pyramid
+    // visible to later compute reads.
+    auto record(
+        vk::raii::CommandBuffer  &cmd,
+        const DepthTarget        &depth,
+        const DepthPyramidTarget &pyramid) const -> void;
+
+  private:
+    ShaderInterface                      shaderInterface;
+    vk::raii::DescriptorPool             descriptorPool;
+    std::vector<vk::raii::DescriptorSet> descriptorSets;
+    vk::raii::PipelineLayout             pipelineLayout;
+    vk::raii::Pipeline                   pipeline;
+
+    // RenderTargets::generation the descriptor sets were written with; a
+    // recreated image may reuse the old handle, so handles cannot tell
+    uint64_t describedGeneration = 0u;
+
+    static auto createDescriptorPool(Device &device) -> vk::raii::DescriptorPool;
+
+    static auto createPipelineLayout(
+        Device                       &device,
+        const vk::DescriptorSetLayout setLayout) -> vk::raii::PipelineLayout;
+
+    static auto createPipeline(
+        Device                         &device,
+        const PipelineCache            &pipelineCache,
+        const std::filesystem::path    &shaderPath,
+        const vk::raii::PipelineLayout &pipelineLayout) -> vk::raii::Pipeline;
+};
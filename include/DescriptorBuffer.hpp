@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "Allocator.hpp"
+#include "Buffer.hpp"
+#include "Device.hpp"
+#include "PhysicalDevice.hpp"
+#include "ShaderInterfaceDescription.hpp"
+
+// VK_EXT_descriptor_buffer backend for one descriptor set layout.
+//
+// One host-visible buffer holds a copy of the set per frame slot, each at a
+// descriptorBufferOffsetAlignment-aligned offset. Descriptors are written
+// straight into the mapped memory with vkGetDescriptorEXT, and binding a
+// frame's set is a buffer offset: no descriptor pool, sets or
+// vkUpdateDescriptorSets.
+//
+// The layout must be created with eDescriptorBufferEXT and pipelines using it
+// with PipelineCreateFlagBits::eDescriptorBufferEXT.
+class DescriptorBuffer
+{
+  public:
+    DescriptorBuffer(
+        const PhysicalDevice                &physicalDevice,
+        Device                              &device,
+        Allocator                           &allocator,
+        const vk::raii::DescriptorSetLayout &layout,
+        const ShaderInterfaceDescription    &description,
+        uint32_t                             maxFramesInFlight);
+
+    // Requires the extension to be enabled on device and the descriptorBuffer
+    // feature.
+    [[nodiscard]]
+    static auto supported(
+        const PhysicalDevice &physicalDevice,
+        const Device         &device) -> bool;
+
+    // Writers for frame slot frameIndex; the slot must not be in use by the
+    // GPU. range must not be vk::WholeSize.
+    auto writeBuffer(
+        uint32_t           frameIndex,
+        uint32_t           binding,
+        vk::DescriptorType type,
+        vk::Buffer         buffer,
+        vk::DeviceSize     range) -> void;
+
+    auto writeSampledImages(
+        uint32_t                       frameIndex,
+        uint32_t                       binding,
+        std::span<const vk::ImageView> views) -> void;
+
+    auto writeSamplers(
+        uint32_t                     frameIndex,
+        uint32_t                     binding,
+        std::span<const vk::Sampler> samplers) -> void;
+
+    // Make frameIndex's writes visible to the device; call after the last
+    // write to the slot. A no-op on host-coherent memory.
+    auto flush(uint32_t frameIndex) const -> void;
+
+    // Bind the buffer and point set 0 of layout at frameIndex's copy.
+    auto bind(
+        const vk::raii::CommandBuffer &cmd,
+        vk::PipelineBindPoint          bindPoint,
+        vk::PipelineLayout             layout,
+        uint32_t                       frameIndex) const -> void;
+
+  private:
+    Device &device;
+
+    vk::PhysicalDeviceDescriptorBufferPropertiesEXT properties;
+
+    VmaAllocator      allocator = nullptr;
+    Buffer            buffer;
+    std::byte        *mapped = nullptr;
+    vk::DeviceAddress address{};
+
+    // bytes between two frame slots
+    vk::DeviceSize slotStride = 0u;
+
+    // binding number -> offset inside a slot
+    std::vector<vk::DeviceSize> bindingOffsets;
+
+    [[nodiscard]]
+    auto descriptorSize(vk::DescriptorType type) const -> std::size_t;
+
+    [[nodiscard]]
+    auto descriptorAddress(
+        uint32_t    frameIndex,
+        uint32_t    binding,
+        uint32_t    arrayElement,
+        std::size_t size) const -> std::byte *;
+};
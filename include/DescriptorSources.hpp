@@ -0,0 +1,25 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Generations of the resources a descriptor set references. Owners take a
+// new generation whenever they recreate a bound resource; a set is rewritten
+// only when the generations it was written with differ. Zero means "never
+// written".
+struct DescriptorSources {
+    std::uint64_t resources      = 0u; // RenderableResources::generation
+    std::uint64_t uniformBuffers = 0u; // FrameContext::uniformBuffersGeneration
+    std::uint64_t renderTargets  = 0u; // RenderTargets::generation
+
+    auto operator==(const DescriptorSources &) const -> bool = default;
+};
+
+// Process-wide, so generations of different owners never collide.
+[[nodiscard]]
+inline auto nextDescriptorSourceGeneration() -> std::uint64_t
+{
+    static std::atomic<std::uint64_t> counter{0u};
+
+    return ++counter;
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
 #include <vulkan/vulkan_raii.hpp>
 
 #include "PhysicalDevice.hpp"
@@ -9,6 +12,14 @@
 struct QueueFamilyIndices {
     uint32_t graphicsIndex = std::numeric_limits<uint32_t>::max();
     uint32_t presentIndex  = std::numeric_limits<uint32_t>::max();
+    // a transfer-only family when the device has one, graphicsIndex otherwise
+    uint32_t transferIndex = std::numeric_limits<uint32_t>::max();
+
+    [[nodiscard]]
+    auto dedicatedTransfer() const -> bool
+    {
+        return transferIndex != graphicsIndex;
+    }
 
     auto complete() const -> bool
     {
@@ -19,24 +30,40 @@ struct QueueFamilyIndices {
 };
 
 struct Device {
+    // optionalExtensions are enabled when the physical device supports them;
+    // query with hasExtension().
     Device(
         const PhysicalDevice            &physicalDevice,
         const Window                    &window,
         const Surface                   &surface,
-        const std::vector<const char *> &requiredExtensions);
+        const std::vector<const char *> &requiredExtensions,
+        const std::vector<const char *> &optionalExtensions = {});
 
-    static auto createDevice(
+    static auto selectExtensions(
         const PhysicalDevice            &physicalDevice,
-        const QueueFamilyIndices        &queueFamilyIndices,
-        const std::vector<const char *> &requiredExtensions) -> vk::raii::Device;
+        const std::vector<const char *> &requiredExtensions,
+        const std::vector<const char *> &optionalExtensions)
+        -> std::vector<std::string>;
+
+    static auto createDevice(
+        const PhysicalDevice           &physicalDevice,
+        const QueueFamilyIndices       &queueFamilyIndices,
+        const std::vector<std::string> &extensions) -> vk::raii::Device;
 
     static auto findQueueFamilies(
         const PhysicalDevice &physicalDevice,
         const Surface        &surface) -> QueueFamilyIndices;
 
-    const Window      &window;
-    QueueFamilyIndices queueFamilyIndices;
-    vk::raii::Device   handle;
+    [[nodiscard]]
+    auto hasExtension(std::string_view extension) const -> bool;
+
+    const PhysicalDevice    &physicalDevice;
+    const Window            &window;
+    QueueFamilyIndices       queueFamilyIndices;
+    std::vector<std::string> enabledExtensions;
+    vk::raii::Device         handle;
     vk::raii::Queue    graphicsQueue;
     vk::raii::Queue    presentQueue;
+    // same queue as graphicsQueue without a dedicated transfer family
+    vk::raii::Queue    transferQueue;
 };
@@ -2,21 +2,28 @@
 
 #include <cstdint>
 #include <glm/vec4.hpp>
+#include <vulkan/vulkan.hpp>
 
 struct DrawItem {
     // Geometry
     uint32_t indexCount   = 0u; // vkCmdDrawIndexed indexCount
-    uint32_t firstIndex   = 0u; // usually 0 for now
-    int32_t  vertexOffset = 0;  // usually 0 for now
+    uint32_t firstIndex   = 0u; // into RenderableResources::indexBuffer
+    int32_t  vertexOffset = 0;  // into RenderableResources::vertexBuffer
+
+    // selects the indexBuffer section firstIndex counts in
+    vk::IndexType indexType = vk::IndexType::eUint32;
 
     // glTF
     uint32_t meshIndex    = 0u;
     uint32_t submeshIndex = 0u;
 
-    // GPU slot
+    // GPU slot (RenderableResources::geometryRanges)
     uint32_t geometryIndex = 0u;
 
     // instance/material
     uint32_t nodeInstanceIndex = 0u;
     uint32_t materialIndex     = 0u;
+
+    // Submesh::uvEncoding
+    uint32_t uvEncoding = 0u;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <vector>
 
 #include <vulkan/vulkan_raii.hpp>
@@ -9,6 +10,7 @@
 #include "Buffer.hpp"
 #include "Command.hpp"
 #include "Device.hpp"
+#include "TransientRing.hpp"
 
 class FrameContext
 {
@@ -43,8 +45,11 @@ class FrameContext
     [[nodiscard]]
     auto setDescriptorSets(std::vector<vk::raii::DescriptorSet> &&sets);
 
+    // persistent per slot rather than on transientRing; see TransientRing
     std::vector<Buffer> frameUBO;
     std::vector<Buffer> nodeInstancesSSBO;
+    // new value whenever the buffers above are recreated
+    uint64_t uniformBuffersGeneration = 0u;
 
     // Per-frame descriptor sets
     std::vector<vk::raii::DescriptorSet> descriptorSets;
@@ -53,6 +58,15 @@ class FrameContext
         Allocator &allocator,
         uint32_t   nodeInstanceCount) -> void;
 
+    // Per-frame transient data of any size; space is reclaimed once the
+    // frame slot's timeline value is reached.
+    std::optional<TransientRing> transientRing;
+
+    auto initializeTransientRing(
+        Device        &device,
+        Allocator     &allocator,
+        vk::DeviceSize capacity) -> void;
+
   private:
     static auto createTimelineSemaphore(
         Device  &device,
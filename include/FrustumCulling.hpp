@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_float4.hpp>
+
+#include "AABB.hpp"
+
+// View frustum as six inward-facing planes (xyz = normal, w = distance), so
+// a point p is inside when dot(plane.xyz, p) + plane.w >= 0 for all planes.
+struct Frustum {
+    std::array<glm::vec4, 6> planes{};
+
+    // Planes of a Vulkan (zero-to-one depth) view-projection matrix.
+    static auto fromViewProjection(const glm::mat4 &viewProjection) -> Frustum;
+};
+
+// World-space draw bounds in structure-of-arrays form (center/half extent
+// per axis), padded to a multiple of kLaneCount so the SIMD loop never
+// needs a scalar tail. Index i is draw i of RenderableResources::draws.
+class DrawBoundsSoA
+{
+  public:
+    static constexpr std::size_t kLaneCount = 8u;
+
+    auto clear() -> void;
+    auto reserve(std::size_t count) -> void;
+
+    // Invalid bounds are stored as a box with a huge negative extent, which
+    // every plane test rejects.
+    auto push(const AABB &worldAABB) -> void;
+
+    // Replace the bounds at index (< size()).
+    auto set(
+        std::size_t index,
+        const AABB &worldAABB) -> void;
+
+    [[nodiscard]]
+    auto size() const -> std::size_t
+    {
+        return count;
+    }
+
+  private:
+    friend struct FrustumCuller;
+
+    auto pad() -> void;
+
+    std::size_t count = 0u;
+
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+
+    std::vector<float> extentX;
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+};
+
+struct CullStats {
+    std::uint32_t tested = 0u;
+    std::uint32_t culled = 0u;
+};
+
+struct FrustumCuller {
+    // Writes the indices of draws whose bounds intersect frustum to
+    // visibleDrawIndices (ascending, so draw order is preserved). Uses AVX2
+    // (8 boxes per iteration) when the CPU supports it, else SSE2 (4), else
+    // scalar code.
+    static auto cull(
+        const Frustum              &frustum,
+        const DrawBoundsSoA        &bounds,
+        std::vector<std::uint32_t> &visibleDrawIndices) -> CullStats;
+};
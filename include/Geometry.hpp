@@ -1,34 +1,127 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.hpp>
 
+// MeshVertex::normalTangent of a vertex without a normal.
+inline constexpr std::array<std::int16_t, 4> kPackedNoNormal{0, 0, 32767, 0};
+
+// Packed vertex, 32 bytes. Must match createPipeline() attribute formats
+// and the decode in mesh_basepass.slang; see VertexPacking.hpp for the
+// encoders.
 struct MeshVertex {
+    // float, so quantized (KHR_mesh_quantization) positions stay exact
     glm::vec3 position{0.0f};
-    glm::vec3 normal{0.0f};
 
-    glm::vec4 tangent{0.0f, 0.0f, 0.0f, 1.0f};
+    // snorm16 x4:
+    // xy: octahedral normal
+    // z:  tangent angle around the normal / pi
+    // w:  bitangent sign, 0 when there is no tangent
+    // No tangent and z = 1 marks a vertex without a normal.
+    std::array<std::int16_t, 4> normalTangent = kPackedNoNormal;
 
-    glm::vec2 uv0{0.0f};
-    glm::vec2 uv1{0.0f};
+    // x2, as Submesh::uvEncoding says: half, or unorm16/snorm16 for
+    // normalized integer (KHR_mesh_quantization) texcoords
+    std::uint32_t uv0 = 0u;
+    std::uint32_t uv1 = 0u;
 
-    glm::vec4 color{1.0f};
+    // unorm8 x4, RGBA
+    std::uint32_t color = 0xffffffffu;
 };
 
+static_assert(sizeof(MeshVertex) == 32u);
+
+// Narrowest index type that addresses vertexCount vertices.
+[[nodiscard]]
+inline auto indexTypeForVertexCount(std::size_t vertexCount) -> vk::IndexType
+{
+    return vertexCount <= 0x10000u ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+}
+
 struct Submesh {
+    // Owned geometry, filled by the glTF loader and its post-processing.
     std::vector<MeshVertex>    vertices;
     std::vector<std::uint32_t> indices;
 
+    // Geometry of a cooked asset, viewing the memory-mapped file
+    // (RenderAsset::mappedStorage keeps it alive); used when the owned
+    // vectors are empty. The indices are already at submeshIndexType()
+    // width.
+    std::span<const MeshVertex> mappedVertices;
+    std::span<const std::byte>  mappedIndices;
+
     std::uint32_t materialIndex = 0u;
 
     vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
 
     bool tangentsValid = false;
+
+    // kUvEncoding* of uv0 (bits 0-1) and uv1 (bits 2-3)
+    std::uint32_t uvEncoding = 0u;
+
+    [[nodiscard]]
+    auto vertexData() const -> std::span<const MeshVertex>
+    {
+        return vertices.empty() ? mappedVertices : std::span<const MeshVertex>{vertices};
+    }
+
+    [[nodiscard]]
+    auto vertexCount() const -> std::size_t
+    {
+        return vertexData().size();
+    }
+
+    [[nodiscard]]
+    auto indexCount() const -> std::size_t
+    {
+        if (!indices.empty()) {
+            return indices.size();
+        }
+
+        const std::size_t indexBytes =
+            indexTypeForVertexCount(vertexCount()) == vk::IndexType::eUint16 ? 2u : 4u;
+
+        return mappedIndices.size() / indexBytes;
+    }
 };
 
+// Narrowest index type that addresses every vertex of the submesh; the GPU
+// index buffer stores the submesh's indices at that width.
+[[nodiscard]]
+inline auto submeshIndexType(const Submesh &submesh) -> vk::IndexType
+{
+    return indexTypeForVertexCount(submesh.vertexCount());
+}
+
+// The submesh's indices at submeshIndexType() width. Owned 32-bit indices of
+// a 16-bit submesh are narrowed into scratch, which must outlive the result.
+[[nodiscard]]
+inline auto gpuIndexBytes(const Submesh              &submesh,
+                          std::vector<std::uint16_t> &scratch) -> std::span<const std::byte>
+{
+    if (submesh.indices.empty()) {
+        return submesh.mappedIndices;
+    }
+
+    if (submeshIndexType(submesh) == vk::IndexType::eUint32) {
+        return std::as_bytes(std::span{submesh.indices});
+    }
+
+    scratch.resize(submesh.indices.size());
+    std::ranges::transform(submesh.indices, scratch.begin(), [](std::uint32_t index) {
+        return static_cast<std::uint16_t>(index);
+    });
+
+    return std::as_bytes(std::span{scratch});
+}
+
 struct Mesh {
     std::vector<Submesh> submeshes;
 };
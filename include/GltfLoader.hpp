@@ -2,6 +2,41 @@
 
 #include <filesystem>
 
+#include "MeshOptimization.hpp"
 #include "RenderAsset.hpp"
 
-auto getAsset(const std::filesystem::path &gltfPath) -> RenderAsset;
+struct AssetLoadOptions {
+    // Memory-map the glTF/GLB file, external buffers and image files so that
+    // accessors and image decode read straight from the page cache instead
+    // of heap copies.
+    bool memoryMapped = true;
+
+    // Load from a cooked snapshot when it is up to date with the source
+    // files, and write one after a full glTF load otherwise.
+    bool useCookedAsset = true;
+
+    // Cooked file location; empty means defaultCookedAssetPath(gltfPath).
+    std::filesystem::path cookedPath;
+
+    // Build full mip chains for decoded images (sRGB-correct for images
+    // sampled as colour).
+    bool generateMipmaps = true;
+
+    // Block-compress decoded images after mip generation: BC7 for colour
+    // and packed data, BC5 for normal maps, BC4 for single-channel data,
+    // each only if textureFormats has it; others stay RGBA8.
+    bool compressTextures = true;
+
+    // Reorder submesh triangles and vertices for the post-transform cache,
+    // overdraw and vertex fetch; the ACMR change is printed after loading.
+    MeshOptimizationOptions meshOptimization{};
+
+    // Block-compressed formats the device can sample (see
+    // queryTextureFormatSupport); KTX2 Basis Universal images are
+    // transcoded to one of these, RGBA8 otherwise.
+    TextureFormatSupport textureFormats{};
+};
+
+auto getAsset(
+    const std::filesystem::path &gltfPath,
+    const AssetLoadOptions      &options = {}) -> RenderAsset;
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "Device.hpp"
+#include "PhysicalDevice.hpp"
+#include "Texture.hpp"
+
+// Texture uploads through host image copy (VK_EXT_host_image_copy, core in
+// Vulkan 1.4): the CPU writes texels straight into a device-local image, with
+// no staging buffer, copy command or barrier. The copy is complete when
+// upload() returns, so textures can be filled from worker threads.
+class HostImageCopy
+{
+  public:
+    HostImageCopy(
+        const PhysicalDevice &physicalDevice,
+        Device               &device);
+
+    // True if an image made from imageInfo plus eHostTransfer usage can be
+    // host-copied in eShaderReadOnlyOptimal without losing device access
+    // performance. Callers fall back to UploadQueue otherwise.
+    [[nodiscard]]
+    auto supports(const vk::ImageCreateInfo &imageInfo) const -> bool;
+
+    // Transition every mip level of image (created from textureImage with
+    // eHostTransfer, not in use by the device) from eUndefined to
+    // eShaderReadOnlyOptimal and copy textureImage's levels into it.
+    // Thread-safe for distinct images.
+    auto upload(
+        vk::Image           image,
+        const TextureImage &textureImage) const -> void;
+
+  private:
+    const PhysicalDevice &physicalDevice;
+    Device               &device;
+
+    // feature enabled and eShaderReadOnlyOptimal is a host copy destination
+    bool enabled = false;
+};
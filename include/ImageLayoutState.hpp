@@ -11,6 +11,7 @@ enum class ImageUse : std::uint8_t {
     kColorAttachmentWrite,
     kDepthAttachmentWrite,
     kShaderSampledRead,
+    kComputeStorageReadWrite,
     kTransferDstWrite,
     kPresent,
 };
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "Texture.hpp"
+
+// KTX2 containers (the KHR_texture_basisu image format), 2D, one layer and
+// one face, with the file's mip levels.
+//
+// - GPU-native payloads (a block-compressed or RGBA8 vkFormat without
+//   supercompression) are read as stored, if formats supports them.
+// - Basis Universal payloads (vkFormat undefined; ETC1S/BasisLZ or UASTC,
+//   optionally Zstandard supercompressed) are transcoded with the Basis
+//   Universal transcoder (third_party/basis_universal): two-channel files
+//   to BC5, colour to BC7, or BC1 when opaque without BC7, and RGBA8 when
+//   none of those can be sampled.
+
+// True if data starts with the KTX2 file identifier.
+[[nodiscard]]
+auto isKtx2(std::span<const std::byte> data) -> bool;
+
+// Throws std::runtime_error for malformed files and for native formats the
+// device cannot sample, so the loader can fall back to the texture's
+// non-KTX2 source.
+[[nodiscard]]
+auto readKtx2(
+    std::span<const std::byte>  data,
+    const TextureFormatSupport &formats) -> TextureImage;
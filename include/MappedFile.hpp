@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+// Read-only memory mapping of an entire file.
+//
+// Pages are faulted in from the page cache on first access, so large files
+// are never copied into heap memory. Move-only; unmaps on destruction.
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::filesystem::path &path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &)                    = delete;
+    auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+    MappedFile(MappedFile &&other) noexcept;
+    auto operator=(MappedFile &&other) noexcept -> MappedFile &;
+
+    [[nodiscard]]
+    auto bytes() const -> std::span<const std::byte>;
+
+  private:
+    auto unmap() noexcept -> void;
+
+    const std::byte *data = nullptr;
+    std::size_t      size = 0u;
+
+#if defined(_WIN32)
+    void *fileHandle    = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Geometry.hpp"
+
+// Load-time reordering of triangle-list submeshes. Each pass can be switched
+// off on its own.
+struct MeshOptimizationOptions {
+    // Tipsify triangle order for the post-transform vertex cache.
+    bool vertexCache = true;
+
+    // Draw the clusters the vertex cache pass produces front to back from the
+    // mesh centre, so outward-facing surfaces occlude the rest. Needs
+    // vertexCache.
+    bool overdraw = true;
+
+    // Renumber vertices in first-use order for sequential vertex fetch;
+    // unreferenced vertices are dropped.
+    bool vertexFetch = true;
+};
+
+// Vertex shader invocations over a simulated FIFO post-transform cache,
+// summed over every optimized submesh.
+struct VertexCacheStats {
+    std::uint64_t triangles        = 0u;
+    std::uint64_t transformsBefore = 0u;
+    std::uint64_t transformsAfter  = 0u;
+
+    // average cache miss ratio: transformed vertices per triangle
+    [[nodiscard]]
+    auto acmrBefore() const -> double
+    {
+        return triangles == 0u ? 0.0
+                               : static_cast<double>(transformsBefore)
+                                     / static_cast<double>(triangles);
+    }
+
+    [[nodiscard]]
+    auto acmrAfter() const -> double
+    {
+        return triangles == 0u ? 0.0
+                               : static_cast<double>(transformsAfter)
+                                     / static_cast<double>(triangles);
+    }
+};
+
+// Optimize every triangle-list submesh, in parallel across submeshes. The
+// result depends only on the input, not on the thread count. Submeshes with
+// out-of-range indices are left as they are.
+auto optimizeMeshes(
+    std::vector<Mesh>             &meshes,
+    const MeshOptimizationOptions &options) -> VertexCacheStats;
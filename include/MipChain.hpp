@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Texture.hpp"
+
+// How texel values are averaged when downsampling.
+enum class MipColorSpace : std::uint32_t {
+    // RGB is sRGB-encoded colour: filtered in linear light and re-encoded,
+    // so minified textures keep their brightness. Alpha is linear.
+    kSrgb,
+    // data (normals, metallic-roughness, occlusion): filtered as stored
+    kLinear,
+};
+
+// Replace the levels of an RGBA8 image with a full chain down to 1x1 built
+// from level 0.
+// Each level is a box filter of the previous one, computed in float so
+// rounding does not accumulate down the chain. Even dimensions average
+// texel pairs; odd ones use 3-tap polyphase weights, so every source row
+// and column contributes. The filter is separable and SSE2 on x86-64.
+auto generateMipChain(
+    TextureImage &image,
+    MipColorSpace colorSpace) -> void;
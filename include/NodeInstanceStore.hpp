@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "Allocator.hpp"
+#include "Buffer.hpp"
+#include "ShaderInterfaceTypes.hpp"
+
+// CPU copy of the per-frame NodeInstanceData SSBO contents with per-instance
+// dirty tracking.
+//
+// Every frame slot keeps its own dirty bitset: set() marks the instance in
+// all of them, and upload() copies only the instances dirty for that slot,
+// merged into contiguous ranges, into the slot's persistently mapped buffer.
+// A slot converges after it has been uploaded once, so a static scene stops
+// uploading after one round of frames.
+class NodeInstanceStore
+{
+  public:
+    NodeInstanceStore(
+        std::vector<NodeInstanceData> instances,
+        uint32_t                      frameSlotCount);
+
+    [[nodiscard]]
+    auto size() const -> uint32_t
+    {
+        return static_cast<uint32_t>(instances.size());
+    }
+
+    [[nodiscard]]
+    auto data() const -> std::span<const NodeInstanceData>
+    {
+        return instances;
+    }
+
+    auto set(
+        uint32_t                index,
+        const NodeInstanceData &instance) -> void;
+
+    // Instances set() since the last call, each once, for CPU data derived
+    // from the transforms (RenderableResources::updateWorldBounds).
+    auto takeChangedInstances() -> std::vector<uint32_t>;
+
+    // Copy what frameSlot has not seen yet into ssbo, which must be host
+    // mapped and hold size() instances. A new bufferGeneration (the buffer
+    // was recreated) uploads everything. Returns the bytes written.
+    auto upload(
+        const Allocator &allocator,
+        uint32_t         frameSlot,
+        const Buffer    &ssbo,
+        uint64_t         bufferGeneration) -> vk::DeviceSize;
+
+  private:
+    // dirty runs separated by fewer clean instances than this are merged
+    static constexpr uint32_t kMergeGap = 4u;
+
+    std::vector<NodeInstanceData> instances;
+
+    // per frame slot: one bit per instance, and the buffer generation the
+    // bits are relative to
+    std::vector<std::vector<uint64_t>> dirtyBits;
+    std::vector<uint64_t>              uploadedGenerations;
+
+    // takeChangedInstances() state, independent of the frame slots
+    std::vector<uint32_t> changedInstances;
+    std::vector<bool>     changedFlags;
+
+    auto markAllDirty(uint32_t frameSlot) -> void;
+};
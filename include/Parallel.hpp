@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Number of worker threads used by parallelFor (hardware concurrency, >= 1).
+[[nodiscard]]
+auto workerThreadCount() -> std::size_t;
+
+// Invoke body(index) for every index in [0, count) across worker threads.
+//
+// Indices are claimed dynamically, so the order in which bodies run is
+// unspecified; callers write results into pre-sized slots to stay
+// deterministic. The first exception thrown by any body is rethrown on the
+// calling thread once every worker has finished.
+auto parallelFor(
+    std::size_t                              count,
+    const std::function<void(std::size_t)> &body) -> void;
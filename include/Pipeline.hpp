@@ -1,12 +1,15 @@
 #pragma once
 
 #include "Device.hpp"
+#include "PipelineCache.hpp"
 
 #include <filesystem>
 
 auto createPipeline(
     Device                      &device,
+    const PipelineCache         &pipelineCache,
     const std::filesystem::path &shaderPath,
     vk::Format                   imageFormat,
     vk::Format                   depthFormat,
-    vk::raii::PipelineLayout    &pipelineLayout) -> vk::raii::Pipeline;
+    vk::raii::PipelineLayout    &pipelineLayout,
+    vk::PipelineCreateFlags      flags = {}) -> vk::raii::Pipeline;
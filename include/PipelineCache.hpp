@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "Device.hpp"
+#include "PhysicalDevice.hpp"
+
+// VkPipelineCache persisted across runs.
+//
+// The file is a small header followed by the driver's cache blob. The header
+// records the vendor/device IDs, driver version and pipelineCacheUUID of the
+// device that wrote it, plus the blob size and hash. A file that is missing,
+// truncated, corrupt or from another device/driver is ignored and the cache
+// starts empty; the driver never sees data it did not produce.
+struct PipelineCache {
+    PipelineCache(
+        const PhysicalDevice  &physicalDevice,
+        Device                &device,
+        std::filesystem::path  path);
+
+    // Write the current cache contents to path. Errors are reported on
+    // stderr and otherwise ignored: a lost cache only costs compile time.
+    auto save() const -> void;
+
+    std::filesystem::path   path;
+    vk::raii::PipelineCache handle = nullptr;
+
+  private:
+    vk::PhysicalDeviceProperties deviceProperties;
+
+    // Returns an empty vector unless the file at path was written for
+    // deviceProperties.
+    [[nodiscard]]
+    auto load() const -> std::vector<std::byte>;
+};
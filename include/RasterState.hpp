@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "Material.hpp"
+
+// Per-draw fixed-function state, set through extended dynamic state so one
+// graphics pipeline serves every glTF material mode.
+struct RasterState {
+    vk::CullModeFlags cullMode  = vk::CullModeFlagBits::eBack;
+    vk::FrontFace     frontFace = vk::FrontFace::eCounterClockwise;
+
+    vk::Bool32 blendEnable      = vk::False;
+    vk::Bool32 depthWriteEnable = vk::True;
+
+    auto operator==(const RasterState &) const -> bool = default;
+
+    // Total order used to group draws with equal state.
+    [[nodiscard]]
+    auto key() const -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(blendEnable) << 4u
+             | static_cast<std::uint32_t>(frontFace) << 3u
+             | static_cast<std::uint32_t>(!depthWriteEnable) << 2u
+             | static_cast<std::uint32_t>(
+                   static_cast<vk::CullModeFlags::MaskType>(cullMode));
+    }
+};
+
+// glTF material state; mirrored (negative determinant) node transforms flip
+// the winding of front faces.
+[[nodiscard]]
+inline auto makeRasterState(
+    const MaterialCore &material,
+    bool                mirrored) -> RasterState
+{
+    return RasterState{
+        .cullMode  = material.doubleSided ? vk::CullModeFlags{vk::CullModeFlagBits::eNone}
+                                          : material.cullMode,
+        .frontFace = mirrored ? vk::FrontFace::eClockwise
+                              : vk::FrontFace::eCounterClockwise,
+        .blendEnable      = material.alphaBlendEnable,
+        .depthWriteEnable = material.alphaBlendEnable ? vk::False : vk::True,
+    };
+}
+
+// Records every dynamic state covered by RasterState.
+inline auto setRasterState(
+    const vk::raii::CommandBuffer &cmd,
+    const RasterState             &state) -> void
+{
+    // glTF BLEND: straight alpha "over"
+    constexpr auto blendEquation = vk::ColorBlendEquationEXT{
+        vk::BlendFactor::eSrcAlpha,
+        vk::BlendFactor::eOneMinusSrcAlpha,
+        vk::BlendOp::eAdd,
+        vk::BlendFactor::eOne,
+        vk::BlendFactor::eOneMinusSrcAlpha,
+        vk::BlendOp::eAdd,
+    };
+
+    cmd.setCullMode(state.cullMode);
+    cmd.setFrontFace(state.frontFace);
+    cmd.setDepthWriteEnable(state.depthWriteEnable);
+    cmd.setColorBlendEnableEXT(0u, state.blendEnable);
+    cmd.setColorBlendEquationEXT(0u, blendEquation);
+}
+
+// Contiguous run of RenderableResources::draws sharing one RasterState and
+// index type; indirect submission issues one multi-draw per group.
+struct RasterStateGroup {
+    RasterState   state{};
+    vk::IndexType indexType = vk::IndexType::eUint32;
+    std::uint32_t firstDraw = 0u;
+    std::uint32_t drawCount = 0u;
+};
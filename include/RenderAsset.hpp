@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -12,6 +13,8 @@
 #include "Material.hpp"
 #include "Texture.hpp"
 
+class MappedFile;
+
 struct SceneRoots {
     std::vector<std::uint32_t> rootNodeIndices;
 };
@@ -35,8 +38,13 @@ struct RenderAsset {
 
     std::vector<Mesh> meshes;
 
-    std::vector<Material> materials;
-    std::vector<Texture>  textures;
+    std::vector<Material>     materials;
+    std::vector<Texture>      textures;
+    std::vector<TextureImage> images;
 
     std::vector<Camera> cameras;
+
+    // Cooked file that the mapped geometry and image spans point into;
+    // null for assets loaded from glTF.
+    std::shared_ptr<const MappedFile> mappedStorage;
 };
@@ -1,30 +1,40 @@
 #pragma once
 
+#include <filesystem>
 #include <vector>
 
 #include <vulkan/vulkan_raii.hpp>
 
 #include "Allocator.hpp"
 #include "Device.hpp"
+#include "HostImageCopy.hpp"
 #include "Instance.hpp"
 #include "PhysicalDevice.hpp"
+#include "PipelineCache.hpp"
 #include "RenderTargets.hpp"
 #include "Surface.hpp"
 #include "Swapchain.hpp"
+#include "UploadQueue.hpp"
 
 struct RenderContext {
     Instance       instance;
     Surface        surface;
     PhysicalDevice physicalDevice;
     Device         device;
+    HostImageCopy  hostImageCopy;
+    PipelineCache  pipelineCache;
     Allocator      allocator;
+    UploadQueue    uploadQueue;
 
     Swapchain     swapchain;
     RenderTargets renderTargets;
 
     RenderContext(
         Window                          &window,
-        const std::vector<const char *> &requiredExtensions);
+        const std::vector<const char *> &requiredExtensions,
+        const std::vector<const char *> &optionalExtensions,
+        const std::filesystem::path     &pipelineCachePath,
+        vk::DeviceSize                   stagingBytes);
 
     void recreateRenderTargets();
 
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_float3.hpp>
+
+// Draw order bucket, the most significant part of a sort key.
+enum class RenderBucket : std::uint8_t {
+    kOpaque  = 0u,
+    kMasked  = 1u,
+    kBlended = 2u,
+};
+
+// Static per-draw sorting inputs, built once with RenderableResources.
+struct DrawSortInfo {
+    glm::vec3 worldCenter{0.0f};
+
+    RenderBucket  bucket        = RenderBucket::kOpaque;
+    std::uint8_t  pipelineState = 0u; // raster state variant, kPipelineState*
+    std::uint32_t materialIndex = 0u;
+    std::uint32_t geometryIndex = 0u;
+};
+
+inline constexpr std::uint8_t kPipelineStateDoubleSided = 1u << 0u;
+inline constexpr std::uint8_t kPipelineStateMirrored    = 1u << 1u;
+
+// Packed 64-bit draw sort key, most significant bits first:
+//
+//   opaque/masked: bucket:2 | state:6 | depth exponent:8 | material:16 |
+//                  geometry:16 | depth mantissa:16
+//   blended:       bucket:2 | state:6 | inverted depth:24 | material:16 |
+//                  geometry:16
+//
+// Opaque draws go roughly front-to-back (log2 depth buckets), grouped by
+// material and geometry inside each bucket; blended draws go strictly
+// back-to-front. viewDepth is the distance along the view direction;
+// negative values (behind the eye) sort as zero.
+[[nodiscard]]
+auto makeDrawSortKey(
+    const DrawSortInfo &info,
+    float               viewDepth) -> std::uint64_t;
+
+// Per-frame draw order: sort keys for a set of draws, LSD radix sorted.
+class RenderQueue
+{
+  public:
+    // Key and sort drawIndices (indices into sortInfos) for the camera at
+    // viewMatrix.
+    auto build(
+        std::span<const DrawSortInfo> sortInfos,
+        std::span<const std::uint32_t> drawIndices,
+        const glm::mat4               &viewMatrix) -> void;
+
+    // As above, for every draw in sortInfos.
+    auto buildAll(
+        std::span<const DrawSortInfo> sortInfos,
+        const glm::mat4              &viewMatrix) -> void;
+
+    // Sorted draw indices of the last build.
+    [[nodiscard]]
+    auto drawIndices() const -> std::span<const std::uint32_t>
+    {
+        return indices;
+    }
+
+  private:
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint32_t> indices;
+
+    // radix sort ping-pong buffers, kept to avoid per-frame allocation
+    std::vector<std::uint64_t> scratchKeys;
+    std::vector<std::uint32_t> scratchIndices;
+
+    auto sort() -> void;
+};
@@ -40,6 +40,7 @@ class RenderTargetAllocator
     enum class PoolKind : std::uint8_t {
         kColor,
         kDepth,
+        kStorage,
     };
 
     [[nodiscard]]
@@ -51,6 +52,7 @@ class RenderTargetAllocator
     VmaAllocator  vmaAllocator;
     UniqueVmaPool colorPool;
     UniqueVmaPool depthPool;
+    UniqueVmaPool storagePool;
 
     [[nodiscard]]
     auto ensurePool(
@@ -75,14 +77,43 @@ struct ColorTarget {
 
 struct DepthTarget {
     vk::Format          format = vk::Format::eUndefined;
+    vk::Extent2D        extent{};
     UniqueImage         image{};
     vk::raii::ImageView view = nullptr;
+    // depth aspect only, for sampling (the depth pyramid source); null
+    // unless recreated with sampled
+    vk::raii::ImageView sampledView = nullptr;
 
     auto recreate(
         Device                &device,
         RenderTargetAllocator &alloc,
-        vk::Extent2D           extent,
-        vk::Format             depthFormat) -> void;
+        vk::Extent2D           extent_,
+        vk::Format             depthFormat,
+        bool                   sampled) -> void;
+
+    [[nodiscard]]
+    auto range() const -> vk::ImageSubresourceRange;
+};
+
+// Hi-Z pyramid of a depth target: level 0 is the depth extent rounded down
+// to powers of two, every further level halves it down to 1x1. Each texel
+// holds the farthest depth of the region it covers. Lives in eGeneral: levels
+// are written as storage images and read back as sampled images.
+struct DepthPyramidTarget {
+    static constexpr vk::Format kFormat = vk::Format::eR32Sfloat;
+
+    UniqueImage  image{};
+    vk::Extent2D extent{};
+    uint32_t     levelCount = 0u;
+    // all levels
+    vk::raii::ImageView view = nullptr;
+    // one single-level view per level
+    std::vector<vk::raii::ImageView> levelViews;
+
+    auto recreate(
+        Device                &device,
+        RenderTargetAllocator &alloc,
+        vk::Extent2D           depthExtent) -> void;
 
     [[nodiscard]]
     auto range() const -> vk::ImageSubresourceRange;
@@ -92,7 +123,13 @@ struct RenderTargets {
     RenderTargetAllocator allocator;
     ColorTarget           sceneColorLdr{};
     DepthTarget           mainDepth{};
+    DepthPyramidTarget    mainDepthPyramid{};
     vk::Extent2D          extent{};
+    // new value on every recreate(); see DescriptorSources
+    uint64_t              generation = 0u;
+    // mainDepthPyramid and mainDepth.sampledView only exist once enabled
+    // (occlusion culling)
+    bool                  depthPyramidEnabled = false;
 
     RenderTargets(
         Device      &device,
@@ -107,6 +144,11 @@ struct RenderTargets {
         vk::Format   swapchainFormat,
         vk::Format   depthFormat) -> void;
 
+    // Allocate the depth pyramid and a sampleable main depth, now and on
+    // every later recreate(). Takes a new generation; no frame may be in
+    // flight.
+    auto enableDepthPyramid(Device &device) -> void;
+
     [[nodiscard]]
     auto images() const -> std::vector<vk::Image>;
 };
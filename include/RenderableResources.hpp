@@ -2,12 +2,20 @@
 
 #include "Allocator.hpp"
 #include "Buffer.hpp"
-#include "Command.hpp"
+#include "DescriptorBuffer.hpp"
 #include "Device.hpp"
 #include "DrawItem.hpp"
+#include "FrustumCulling.hpp"
+#include "HostImageCopy.hpp"
 #include "Image.hpp"
+#include "RasterState.hpp"
 #include "RenderAsset.hpp"
+#include "RenderQueue.hpp"
+#include "ShaderInterfaceTypes.hpp"
+#include "UploadQueue.hpp"
 
+#include <cstdint>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -16,13 +24,21 @@
 
 struct SceneView;
 
+struct GeometryRange {
+    std::uint32_t firstIndex   = 0u; // in indexType units, from its section
+    std::uint32_t indexCount   = 0u;
+    std::int32_t  vertexOffset = 0;
+    vk::IndexType indexType    = vk::IndexType::eUint32;
+};
+
 struct RenderableResources {
     void create(
-        const RenderAsset &asset,
-        const SceneView   &sceneView,
-        Device            &device,
-        Command           &command,
-        Allocator         &allocator);
+        const RenderAsset   &asset,
+        const SceneView     &sceneView,
+        Device              &device,
+        UploadQueue         &uploads,
+        const HostImageCopy &hostImageCopy,
+        Allocator           &allocator);
 
     void updateDescriptorSet(
         Device           &device,
@@ -30,17 +46,85 @@ struct RenderableResources {
         const Buffer     &frameUBO,
         const Buffer     &nodeInstancesSSBO) const;
 
-    // draw list consumed by Renderer
+    // Same bindings as updateDescriptorSet, written into frameIndex's slot of
+    // a descriptor buffer.
+    void updateDescriptorBuffer(
+        DescriptorBuffer &descriptorBuffer,
+        uint32_t          frameIndex,
+        const Buffer     &frameUBO,
+        const Buffer     &nodeInstancesSSBO) const;
+
+    // Recompute worldDrawBounds and drawSortInfos[].worldCenter for the
+    // draws of changedInstances (NodeInstanceStore::takeChangedInstances())
+    // from their current transforms, so CPU culling and the blended depth
+    // sort follow moved instances.
+    void updateWorldBounds(
+        std::span<const NodeInstanceData> instances,
+        std::span<const std::uint32_t>    changedInstances);
+
+    // new value on every create(); descriptor sets referencing these
+    // resources are rewritten when it changes (DescriptorSources)
+    std::uint64_t generation = 0u;
+
+    // draw list consumed by Renderer, ordered by RasterState::key() so equal
+    // states form contiguous groups
     std::vector<DrawItem> draws;
 
-    // static GPU data consumed by Renderer
-    std::vector<Buffer> indexBuffers;
-    std::vector<Buffer> vertexBuffers;
+    // per-draw dynamic raster state, and the runs of equal state in draws
+    std::vector<RasterState>      drawRasterStates;
+    std::vector<RasterStateGroup> rasterStateGroups;
+
+    // draws from here on are blended; RasterState::key() orders them last
+    std::uint32_t firstBlendedDraw = 0u;
+
+    // static GPU data consumed by Renderer: every submesh is suballocated
+    // from one vertex and one index buffer. indexBuffer holds the 16-bit
+    // indices first and the 32-bit ones from index32Offset; each section is
+    // bound with its own type.
+    Buffer         vertexBuffer;
+    Buffer         indexBuffer;
+    vk::DeviceSize index32Offset = 0u;
 
+    [[nodiscard]]
+    auto indexBufferOffset(vk::IndexType indexType) const -> vk::DeviceSize
+    {
+        return indexType == vk::IndexType::eUint16 ? 0u : index32Offset;
+    }
+
+    // geometry index -> range of that submesh in vertexBuffer/indexBuffer
+    std::vector<GeometryRange> geometryRanges;
+
+    // indirect submission: one command per draw (firstInstance = draw index)
+    // and the matching DrawData entry
+    Buffer        indirectCommandsBuffer;
+    Buffer        drawDataSSBO;
+    std::uint32_t indirectDrawCount = 0u;
+
+    // per-draw local bounds + node instance, read by the frustum cull pass
+    Buffer drawBoundsSSBO;
+
+    // per-draw world bounds for CPU frustum culling, kept current by
+    // updateWorldBounds()
+    DrawBoundsSoA worldDrawBounds;
+
+    // per-draw local bounds, and the draws of each node instance:
+    // instanceDraws[instanceDrawOffsets[i] .. instanceDrawOffsets[i + 1]]
+    std::vector<AABB>          localDrawBounds;
+    std::vector<std::uint32_t> instanceDrawOffsets;
+    std::vector<std::uint32_t> instanceDraws;
+
+    // per-draw RenderQueue inputs; worldCenter kept current by
+    // updateWorldBounds()
+    std::vector<DrawSortInfo> drawSortInfos;
+
+    // one GPU image (and sRGB/linear view pair) per RenderAsset::images entry
     std::vector<Image>               textureImages;
     std::vector<vk::raii::ImageView> srgbTextureImageViews;
     std::vector<vk::raii::ImageView> linearTextureImageViews;
 
+    // texture index -> index into textureImages / *TextureImageViews
+    std::vector<std::uint32_t> textureImageIndices;
+
     Buffer materialsSSBO;
 
     std::vector<vk::Sampler>       samplerHandles;
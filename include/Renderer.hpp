@@ -1,11 +1,19 @@
 #pragma once
 
+#include <optional>
+
 #include <vulkan/vulkan_raii.hpp>
 
+#include "CullPass.hpp"
 #include "DebugView.hpp"
+#include "DepthPyramidPass.hpp"
+#include "DescriptorBuffer.hpp"
+#include "DescriptorSources.hpp"
 #include "FrameContext.hpp"
+#include "FrustumCulling.hpp"
 #include "ImageLayoutState.hpp"
 #include "RenderContext.hpp"
+#include "RenderQueue.hpp"
 #include "RendererConfig.hpp"
 #include "ShaderInterface.hpp"
 
@@ -21,6 +29,23 @@ struct Renderer {
     [[nodiscard]]
     auto beginFrame() -> bool;
 
+    // CPU frustum culling for direct submission; call once per frame before
+    // render(). Returns zero stats when CPU culling is inactive.
+    auto cullDraws(
+        const RenderableResources &renderableResources,
+        const glm::mat4           &viewProjection) -> CullStats;
+
+    // Order this frame's direct draws (the culled set, if CPU culling ran)
+    // by RenderQueue sort key, or the blended draws of indirect submission;
+    // call after cullDraws(). No-op unless draw sorting is active.
+    auto sortDraws(
+        const RenderableResources &renderableResources,
+        const glm::mat4           &viewMatrix) -> void;
+
+    // Write the current frame's base pass descriptor set, unless it already
+    // references exactly these resources; call after beginFrame().
+    auto updateDescriptorSet(const RenderableResources &renderableResources) -> void;
+
     // Records rendering commands into the current frame command buffer
     auto render(const RenderableResources &renderableResources) -> void;
 
@@ -31,18 +56,34 @@ struct Renderer {
     vk::DescriptorSet currentDescriptorSet() const;
     Buffer           &currentFrameUBO();
     Buffer           &currentNodeInstancesSSBO();
+    uint32_t          currentFrameIndex() const;
+    // Suballocations live until this frame has finished on the GPU; valid
+    // between beginFrame() and endFrame().
+    TransientRing    &transientRing();
+    // changes whenever the per-frame uniform buffers are recreated
+    uint64_t          uniformBuffersGeneration() const;
 
     auto initializePerFrameUniformBuffers(
         Allocator &allocator,
         uint32_t   nodeInstancesCount) -> void;
 
+    // Per-frame cull outputs; no-op unless GPU frustum culling is active.
+    auto initializePerFrameCullBuffers(
+        Allocator &allocator,
+        uint32_t   drawCount) -> void;
+
     void cycleDebugView();
 
   private:
     RenderContext   &context;
     ImageLayoutState imageLayoutState;
 
+    // set from RendererConfig::descriptorBuffer and device support before
+    // the layout and pipeline are created
+    bool useDescriptorBuffer = false;
+
     ShaderInterface          shaderInterface;
+    // null with the descriptor buffer backend
     vk::raii::DescriptorPool descriptorPool;
     vk::raii::PipelineLayout pipelineLayout;
     vk::raii::Pipeline       graphicsPipeline;
@@ -50,8 +91,76 @@ struct Renderer {
     // Renderer-owned execution state
     FrameContext frames;
 
+    // transfer timeline wait for uploads acquired by the current frame
+    std::optional<vk::SemaphoreSubmitInfo> uploadWait;
+
+    // engaged instead of per-frame descriptor sets when useDescriptorBuffer
+    std::optional<DescriptorBuffer> descriptorBuffer;
+
+    // per frame slot: what its descriptor set was last written with
+    std::vector<DescriptorSources> describedSources;
+
     DebugView debugView = DebugView::Shaded;
 
+    DrawSubmission drawSubmission = DrawSubmission::Direct;
+
+    // drawIndexedIndirect limits: without multiDrawIndirect every command is
+    // its own call
+    uint32_t maxIndirectDrawsPerCall = 1u;
+
+    // engaged when GPU frustum culling is enabled and supported
+    std::optional<CullPass> cullPass;
+    // engaged with cullPass when occlusion culling is enabled
+    std::optional<DepthPyramidPass> depthPyramidPass;
+
+    // CPU culling result: indices into RenderableResources::draws
+    bool                  cpuFrustumCulling = false;
+    std::vector<uint32_t> visibleDrawIndices;
+
+    // draw order for this frame when drawSorting is set: every direct draw,
+    // or the blended draws of indirect submission
+    bool        drawSorting = false;
+    RenderQueue renderQueue;
+
+    // indirect submission: blended draw indices to sort, and their commands
+    // in sorted order; kept to avoid per-frame allocation
+    std::vector<uint32_t>                        blendedDrawIndices;
+    std::vector<vk::DrawIndexedIndirectCommand> sortedBlendedCommands;
+
+    // index type bound in the current pass; reset when a pass begins
+    std::optional<vk::IndexType> boundIndexType;
+
+    // One dynamic rendering pass over swapchain image + mainDepth. Indirect
+    // draws come from cullList when GPU culling is active; blended draws are
+    // recorded only when drawBlended is set, so they land after every opaque
+    // draw of the frame.
+    auto recordBasePass(
+        const RenderableResources &renderableResources,
+        vk::AttachmentLoadOp       loadOp,
+        vk::AttachmentStoreOp      depthStoreOp,
+        CullList                   cullList,
+        bool                       drawBlended) -> void;
+
+    // Bind indexBuffer's section for indexType unless it is already bound.
+    auto bindIndexBuffer(
+        const RenderableResources &renderableResources,
+        vk::IndexType              indexType) -> void;
+
+    auto recordDirectDraws(const RenderableResources &renderableResources) -> void;
+    auto recordIndirectDraws(
+        const RenderableResources &renderableResources,
+        CullList                   cullList,
+        bool                       drawBlended) -> void;
+
+    // Blended draws in renderQueue order, from commands written to the
+    // transient ring; runs of equal state share one multi-draw.
+    auto recordSortedBlendedDraws(const RenderableResources &renderableResources)
+        -> void;
+
+    [[nodiscard]]
+    auto descriptorSources(const RenderableResources &renderableResources) const
+        -> DescriptorSources;
+
     auto        submit() -> void;
     auto        present() -> void;
     auto        allocateFrameDescriptorSets() -> void;
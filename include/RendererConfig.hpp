@@ -6,6 +6,12 @@
 
 #include <vulkan/vulkan.hpp>
 
+// How Renderer::render submits RenderableResources::draws.
+// - Direct: one push constant update + drawIndexed per draw.
+// - Indirect: per-draw indices come from the DrawData SSBO and the whole
+//   list is drawn with a few drawIndexedIndirect calls.
+enum class DrawSubmission : uint32_t { Direct = 0, Indirect = 1 };
+
 struct RendererConfig {
     ShaderInterfaceDescription shaderInterfaceDescription;
 
@@ -17,4 +23,34 @@ struct RendererConfig {
     vk::Format depthFormat;
 
     uint32_t maxFramesInFlight;
+
+    // Size of the per-frame transient ring (Renderer::transientRing); must
+    // hold maxFramesInFlight frames of transient data.
+    vk::DeviceSize transientRingBytes = 4u << 20u;
+
+    DrawSubmission drawSubmission = DrawSubmission::Direct;
+
+    // Indirect only: cull draws against the view frustum on the GPU before
+    // the base pass (compute shader at cullShaderPath). Devices without
+    // drawIndirectCount/multiDrawIndirect fall back to direct submission
+    // with CPU frustum culling. Blended draws are not culled; they are drawn
+    // after every opaque draw, past the late occlusion pass.
+    bool                  gpuFrustumCulling = false;
+    std::filesystem::path cullShaderPath;
+    // Requires gpuFrustumCulling: two-phase Hi-Z occlusion culling. Draws
+    // visible last frame are rendered first, their depth is reduced to a
+    // pyramid (compute shader at depthPyramidShaderPath) and the remaining
+    // draws are tested against it before a second pass.
+    bool                  gpuOcclusionCulling = false;
+    std::filesystem::path depthPyramidShaderPath;
+    // Direct only: skip draws whose world bounds miss the view frustum
+    // (Renderer::cullDraws, SIMD on the CPU).
+    bool cpuFrustumCulling = false;
+    // Draw in RenderQueue sort-key order (Renderer::sortDraws) instead of
+    // scene traversal order. Indirect submission only reorders the blended
+    // draws (back-to-front); opaque draws keep their raster state groups.
+    bool drawSorting = false;
+    // Bind shaderInterfaceDescription through VK_EXT_descriptor_buffer
+    // instead of descriptor sets, when the device supports it.
+    bool descriptorBuffer = false;
 };
@@ -8,11 +8,13 @@ struct ShaderInterface {
     vk::raii::DescriptorSetLayout handle;
 
     ShaderInterface(
-        Device                           &device,
-        const ShaderInterfaceDescription &description);
+        Device                             &device,
+        const ShaderInterfaceDescription   &description,
+        vk::DescriptorSetLayoutCreateFlags flags = {});
 
   private:
     static auto create(
-        Device                           &device,
-        const ShaderInterfaceDescription &description) -> vk::raii::DescriptorSetLayout;
+        Device                             &device,
+        const ShaderInterfaceDescription   &description,
+        vk::DescriptorSetLayoutCreateFlags flags) -> vk::raii::DescriptorSetLayout;
 };
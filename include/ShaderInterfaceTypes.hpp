@@ -13,6 +13,7 @@
 #if defined(__SLANG__)
 
 typealias u32  = uint;
+typealias i32  = int;
 typealias vec2 = float2;
 typealias vec3 = float3;
 typealias vec4 = float4;
@@ -32,6 +33,7 @@ typealias mat4 = float4x4;
 #include <glm/mat4x4.hpp>
 
 using u32  = std::uint32_t;
+using i32  = std::int32_t;
 using vec2 = glm::vec2;
 using vec3 = glm::vec3;
 using vec4 = glm::vec4;
@@ -52,6 +54,25 @@ NIENNA_CONST u32 kBindingMaterialData  = 2u;
 NIENNA_CONST u32 kBindingImagesSrgb    = 3u;
 NIENNA_CONST u32 kBindingImagesLinear  = 4u;
 NIENNA_CONST u32 kBindingSamplers      = 5u;
+NIENNA_CONST u32 kBindingDrawData      = 6u;
+
+// Frustum cull pass descriptor bindings (separate set layout)
+NIENNA_CONST u32 kCullBindingFrameUniforms    = 0u;
+NIENNA_CONST u32 kCullBindingNodeInstanceData = 1u;
+NIENNA_CONST u32 kCullBindingDrawBounds       = 2u;
+NIENNA_CONST u32 kCullBindingSourceCommands   = 3u;
+NIENNA_CONST u32 kCullBindingVisibleCommands  = 4u;
+NIENNA_CONST u32 kCullBindingVisibleCount     = 5u;
+NIENNA_CONST u32 kCullBindingDrawVisibility   = 6u;
+NIENNA_CONST u32 kCullBindingDepthPyramid     = 7u;
+
+NIENNA_CONST u32 kCullWorkgroupSize = 64u;
+
+// Depth pyramid reduction bindings
+NIENNA_CONST u32 kPyramidBindingSource      = 0u;
+NIENNA_CONST u32 kPyramidBindingDestination = 1u;
+
+NIENNA_CONST u32 kPyramidWorkgroupSize = 8u;
 
 struct NIENNA_ALIGN(16) DirectionalLight {
     vec3  direction NIENNA_INIT(0.0f, -1.0f, -1.0f);
@@ -77,11 +98,64 @@ struct NIENNA_ALIGN(16) NodeInstanceData {
     mat4 modelMatrix NIENNA_INIT(1.0f);
 };
 
+// How MeshVertex::uv0/uv1 are stored; a submesh's uvEncoding holds uv0 in
+// bits 0-1 and uv1 in bits 2-3.
+NIENNA_CONST u32 kUvEncodingHalf    = 0u;
+NIENNA_CONST u32 kUvEncodingUnorm16 = 1u;
+NIENNA_CONST u32 kUvEncodingSnorm16 = 2u;
+
+// Per-draw indices for indirect submission, indexed by the draw's instance
+// index (firstInstance of its indirect command).
+struct NIENNA_ALIGN(16) DrawData {
+    u32 nodeInstanceIndex NIENNA_INIT(0u);
+    u32 materialIndex     NIENNA_INIT(0u);
+    u32 uvEncoding        NIENNA_INIT(0u);
+    u32 _pad0             NIENNA_INIT(0u);
+};
+
+// Mirrors VkDrawIndexedIndirectCommand.
+struct IndirectDrawCommand {
+    u32 indexCount    NIENNA_INIT(0u);
+    u32 instanceCount NIENNA_INIT(0u);
+    u32 firstIndex    NIENNA_INIT(0u);
+    i32 vertexOffset  NIENNA_INIT(0);
+    u32 firstInstance NIENNA_INIT(0u);
+};
+
+// Local-space bounds of a draw's submesh, placed by its node instance.
+// groupFirstDraw is the first draw of the draw's raster state group: visible
+// commands of a group are compacted from that slot on, and their count lives
+// at the same index of the count buffer.
+struct NIENNA_ALIGN(16) DrawBounds {
+    vec3 localMin          NIENNA_INIT(0.0f, 0.0f, 0.0f);
+    u32  nodeInstanceIndex NIENNA_INIT(0u);
+    vec3 localMax          NIENNA_INIT(0.0f, 0.0f, 0.0f);
+    u32  groupFirstDraw    NIENNA_INIT(0u);
+};
+
+// pyramid* describe the depth pyramid; only the late occlusion phase reads
+// them.
+struct CullPushConstants {
+    u32 drawCount         NIENNA_INIT(0u);
+    u32 pyramidWidth      NIENNA_INIT(0u);
+    u32 pyramidHeight     NIENNA_INIT(0u);
+    u32 pyramidLevelCount NIENNA_INIT(0u);
+};
+
+struct DepthPyramidPushConstants {
+    u32 sourceWidth       NIENNA_INIT(0u);
+    u32 sourceHeight      NIENNA_INIT(0u);
+    u32 destinationWidth  NIENNA_INIT(0u);
+    u32 destinationHeight NIENNA_INIT(0u);
+};
+
+// useDrawData != 0: ignore nodeInstanceIndex/materialIndex and read DrawData.
 struct PushConstants {
     u32 nodeInstanceIndex   NIENNA_INIT(0u);
     u32 materialIndex       NIENNA_INIT(0u);
     u32 debugView           NIENNA_INIT(0u);
-    u32 _pad0               NIENNA_INIT(0u);
+    u32 useDrawData         NIENNA_INIT(0u);
+    u32 uvEncoding          NIENNA_INIT(0u);
 };
 
 struct NIENNA_ALIGN(16) TextureTransform2DData {
@@ -162,8 +236,20 @@ static_assert(sizeof(FrameUniforms) == 128u);
 static_assert(alignof(NodeInstanceData) == 16u);
 static_assert(sizeof(NodeInstanceData) == 64u);
 
+static_assert(alignof(DrawData) == 16u);
+static_assert(sizeof(DrawData) == 16u);
+
 static_assert(sizeof(PushConstants) == 16u);
 
+static_assert(sizeof(IndirectDrawCommand) == 20u);
+
+static_assert(alignof(DrawBounds) == 16u);
+static_assert(sizeof(DrawBounds) == 32u);
+
+static_assert(sizeof(CullPushConstants) == 16u);
+
+static_assert(sizeof(DepthPyramidPushConstants) == 16u);
+
 static_assert(alignof(TextureTransform2DData) == 16u);
 static_assert(sizeof(TextureTransform2DData) == 32u);
 
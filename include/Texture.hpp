@@ -1,29 +1,139 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 #include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_format_traits.hpp>
 
-struct Texture {
-    std::vector<std::byte> rgba8;
+// Number of levels in a full mip chain down to 1x1.
+[[nodiscard]]
+inline auto fullMipLevelCount(vk::Extent2D extent) -> std::uint32_t
+{
+    return static_cast<std::uint32_t>(
+        std::bit_width(std::max({extent.width, extent.height, 1u})));
+}
+
+[[nodiscard]]
+inline auto mipLevelExtent(
+    vk::Extent2D  extent,
+    std::uint32_t level) -> vk::Extent2D
+{
+    return vk::Extent2D{
+        std::max(extent.width >> level, 1u),
+        std::max(extent.height >> level, 1u)};
+}
+
+// Block-compressed formats a device can sample (optimal tiling, linear
+// filtering). Asset loading only transcodes or compresses into these;
+// everything else stays RGBA8.
+struct TextureFormatSupport {
+    bool bc1 = false;
+    bool bc3 = false;
+    bool bc4 = false;
+    bool bc5 = false;
+    bool bc7 = false;
+
+    // True for RGBA8 and the supported BC formats, either encoding.
+    [[nodiscard]]
+    auto supports(vk::Format format) const -> bool
+    {
+        switch (format) {
+        case vk::Format::eR8G8B8A8Unorm:
+        case vk::Format::eR8G8B8A8Srgb:
+            return true;
+        case vk::Format::eBc1RgbUnormBlock:
+        case vk::Format::eBc1RgbSrgbBlock:
+        case vk::Format::eBc1RgbaUnormBlock:
+        case vk::Format::eBc1RgbaSrgbBlock:
+            return bc1;
+        case vk::Format::eBc3UnormBlock:
+        case vk::Format::eBc3SrgbBlock:
+            return bc3;
+        case vk::Format::eBc4UnormBlock:
+            return bc4;
+        case vk::Format::eBc5UnormBlock:
+            return bc5;
+        case vk::Format::eBc7UnormBlock:
+        case vk::Format::eBc7SrgbBlock:
+            return bc7;
+        default:
+            return false;
+        }
+    }
+};
 
+// Texel data shared by every texture that references it.
+struct TextureImage {
+    // every mip level, tightly packed, level 0 first
+    std::vector<std::byte> data;
+
+    // Same layout as data, viewing a memory-mapped cooked file instead
+    // (RenderAsset::mappedStorage keeps it alive); used when data is empty.
+    std::span<const std::byte> mappedData;
+
+    // UNORM storage format (RGBA8 or a BC format); the sRGB twin is chosen
+    // per view
+    vk::Format format = vk::Format::eR8G8B8A8Unorm;
+
+    // extent of level 0
     vk::Extent2D extent{0u, 0u};
 
-    vk::SamplerCreateInfo samplerInfo{};
+    std::uint32_t mipLevels = 1u;
+
+    [[nodiscard]]
+    auto levelBytes(std::uint32_t level) const -> std::size_t
+    {
+        const vk::Extent2D levelExtent = mipLevelExtent(extent, level);
+        const auto         blockExtent = vk::blockExtent(format);
+
+        const std::size_t blockColumns =
+            (levelExtent.width + blockExtent[0] - 1u) / blockExtent[0];
+        const std::size_t blockRows =
+            (levelExtent.height + blockExtent[1] - 1u) / blockExtent[1];
+
+        return blockColumns * blockRows * vk::blockSize(format);
+    }
+
+    [[nodiscard]]
+    auto levelOffset(std::uint32_t level) const -> std::size_t
+    {
+        std::size_t offset = 0u;
+
+        for (std::uint32_t previous = 0u; previous < level; ++previous) {
+            offset += levelBytes(previous);
+        }
+
+        return offset;
+    }
+
+    [[nodiscard]]
+    auto bytes() const -> std::span<const std::byte>
+    {
+        return data.empty() ? mappedData : std::span<const std::byte>{data};
+    }
 
     bool isValid() const
     {
-        if (extent.width == 0u || extent.height == 0u) {
+        if (extent.width == 0u || extent.height == 0u || vk::blockSize(format) == 0u) {
             return false;
         }
 
-        const std::size_t w = static_cast<std::size_t>(extent.width);
+        if (mipLevels == 0u || mipLevels > fullMipLevelCount(extent)) {
+            return false;
+        }
 
-        const std::size_t h = static_cast<std::size_t>(extent.height);
+        return bytes().size() == levelOffset(mipLevels);
+    }
+};
 
-        const std::size_t expectedBytes = w * h * 4u;
+// An (image, sampler) pair; several textures may share one TextureImage.
+struct Texture {
+    std::uint32_t imageIndex = 0u;
 
-        return rgba8.size() == expectedBytes;
-    }
+    vk::SamplerCreateInfo samplerInfo{};
 };
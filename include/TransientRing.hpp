@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <span>
+
+#include <vulkan/vulkan.hpp>
+
+#include "Allocator.hpp"
+#include "Buffer.hpp"
+#include "Device.hpp"
+
+// One suballocation of a TransientRing, valid until the frame it was made in
+// has finished on the GPU.
+struct TransientAllocation {
+    vk::Buffer        buffer{};
+    vk::DeviceSize    offset = 0u; // dynamic offset / bind offset into buffer
+    vk::DeviceSize    size   = 0u;
+    vk::DeviceAddress address{};   // device address of offset
+    std::byte        *mapped = nullptr;
+};
+
+// Host-visible linear ring for per-frame data of any size (dynamic
+// vertices/indices, indirect commands); today it carries the sorted blended
+// draw commands of the indirect path.
+//
+// Frame uniforms and node instances stay in FrameContext's per-slot
+// buffers: NodeInstanceStore uploads only changed instances into a buffer
+// that persists across frames, which a ring would turn back into a full copy
+// every frame, and the descriptor buffer path has no dynamic offsets to
+// point the bindings at ring data without rewriting them per frame.
+//
+// Allocations bump a head offset; when a frame is submitted its end is
+// tagged with the timeline value the submission signals, and the space is
+// reclaimed once that value is reached. Nothing is allocated or freed per
+// frame.
+class TransientRing
+{
+  public:
+    // capacity is rounded up to kMaxAlignment and should cover
+    // maxFramesInFlight frames of data.
+    TransientRing(
+        Device        &device,
+        Allocator     &allocator,
+        vk::DeviceSize capacity);
+
+    // Upper bound for allocate() alignments (covers every
+    // min*OffsetAlignment limit).
+    static constexpr vk::DeviceSize kMaxAlignment = 256u;
+
+    // alignment must be a power of two <= kMaxAlignment. Throws when the
+    // ring is full.
+    [[nodiscard]]
+    auto allocate(
+        vk::DeviceSize size,
+        vk::DeviceSize alignment) -> TransientAllocation;
+
+    template <typename T>
+    [[nodiscard]]
+    auto upload(
+        std::span<const T> data,
+        vk::DeviceSize     alignment) -> TransientAllocation
+    {
+        const auto allocation = allocate(data.size_bytes(), alignment);
+
+        std::memcpy(allocation.mapped, data.data(), data.size_bytes());
+
+        return allocation;
+    }
+
+    // Everything allocated since the previous call belongs to the submission
+    // that signals timelineValue. Flushes that range for non-coherent
+    // memory.
+    auto closeFrame(uint64_t timelineValue) -> void;
+
+    // Free the frames whose timeline value is <= completedTimelineValue.
+    auto reclaim(uint64_t completedTimelineValue) -> void;
+
+    [[nodiscard]]
+    auto capacity() const -> vk::DeviceSize
+    {
+        return buffer.size;
+    }
+
+  private:
+    struct FrameMark {
+        uint64_t       timelineValue = 0u;
+        vk::DeviceSize head          = 0u;
+    };
+
+    VmaAllocator      allocator = nullptr;
+    Buffer            buffer;
+    std::byte        *mapped = nullptr;
+    vk::DeviceAddress address{};
+
+    // monotonic byte positions; position % capacity is the buffer offset
+    vk::DeviceSize head = 0u;
+    vk::DeviceSize tail = 0u;
+
+    // head at the previous closeFrame(); [closedHead, head) is unflushed
+    vk::DeviceSize closedHead = 0u;
+
+    // submitted frames not yet reclaimed, oldest first
+    std::deque<FrameMark> frameMarks;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "Buffer.hpp"
+#include "Device.hpp"
+#include "PhysicalDevice.hpp"
+#include "vma.hpp"
+
+struct Allocator;
+
+// Asynchronous uploads on the transfer queue family.
+//
+// Copies are recorded into an open batch and submitted without a CPU wait;
+// each batch signals the next value of the queue's timeline semaphore.
+// Resources written by a batch are released to the graphics family, and the
+// renderer records the matching acquire barriers in its next frame, which
+// waits on the timeline value.
+//
+// Source data goes through one fixed-size, persistently mapped staging ring.
+// Uploads larger than the free space are split into chunks (whole rows for
+// images); when the ring is full the open batch is submitted and the oldest
+// batch is waited for, so staging memory stays at the ring size whatever the
+// asset size. Ring space is reclaimed by timeline value.
+//
+// Without a dedicated transfer family the batch goes to the graphics queue
+// and a plain barrier replaces the release/acquire pair.
+class UploadQueue
+{
+  public:
+    UploadQueue(
+        const PhysicalDevice &physicalDevice,
+        Device               &device,
+        Allocator            &allocator,
+        vk::DeviceSize        stagingCapacity);
+    ~UploadQueue();
+
+    UploadQueue(const UploadQueue &)                     = delete;
+    auto operator=(const UploadQueue &) -> UploadQueue & = delete;
+
+    // Command buffer of the open batch; begins a new batch if none is open.
+    [[nodiscard]]
+    auto cmd() -> vk::raii::CommandBuffer &;
+
+    // Copy data to dst at dstOffset.
+    auto uploadBuffer(
+        std::span<const std::byte> data,
+        vk::Buffer                 dst,
+        vk::DeviceSize             dstOffset = 0u) -> void;
+
+    // Copy tightly packed texel data to one subresource of a 2D image in
+    // eTransferDstOptimal. blockExtent is the texel block size of the format
+    // ({1, 1} for uncompressed), bytesPerBlock its size in bytes.
+    auto uploadImage(
+        std::span<const std::byte> data,
+        vk::Image                  dst,
+        vk::ImageSubresourceLayers subresource,
+        vk::Extent2D               extent,
+        uint32_t                   bytesPerBlock,
+        vk::Extent2D               blockExtent = {1u, 1u}) -> void;
+
+    // Call after the last transfer write of the resource in the open batch.
+    auto releaseBuffer(vk::Buffer buffer) -> void;
+
+    // image must be in eTransferDstOptimal; it ends up in
+    // eShaderReadOnlyOptimal on the graphics family.
+    auto releaseImage(
+        vk::Image                 image,
+        vk::ImageSubresourceRange range) -> void;
+
+    // Submit the open batch. Returns the timeline value that marks its
+    // completion (the last submitted value if no batch was open).
+    auto submit() -> uint64_t;
+
+    // Reclaim staging space and command buffers of completed batches.
+    auto collect() -> void;
+
+    auto wait(uint64_t timelineValue) const -> void;
+
+    // Record the acquire barriers of everything submitted since the previous
+    // call into a graphics command buffer. Returns the wait the graphics
+    // submission needs, if anything was uploaded since then.
+    [[nodiscard]]
+    auto recordAcquires(const vk::raii::CommandBuffer &cmd)
+        -> std::optional<vk::SemaphoreSubmitInfo>;
+
+  private:
+    struct Acquires {
+        std::vector<vk::BufferMemoryBarrier2> buffers;
+        std::vector<vk::ImageMemoryBarrier2>  images;
+    };
+
+    struct Batch {
+        uint64_t                timelineValue = 0u;
+        vk::raii::CommandBuffer cmd{nullptr};
+        // ring head when the batch was submitted
+        vk::DeviceSize stagingHead = 0u;
+    };
+
+    struct StagingChunk {
+        vk::DeviceSize offset = 0u;
+        vk::DeviceSize size   = 0u;
+    };
+
+    Device &device;
+
+    uint32_t srcFamily = 0u;
+    uint32_t dstFamily = 0u;
+
+    // in blocks; {0, 0} allows whole-subresource image copies only
+    vk::Extent3D imageGranularity;
+
+    vk::raii::CommandPool pool;
+    vk::raii::Semaphore   timelineSemaphore;
+
+    VmaAllocator vmaAllocator = nullptr;
+    Buffer       stagingBuffer;
+    std::byte   *stagingMapped = nullptr;
+
+    // monotonic byte positions; position % capacity is the buffer offset
+    vk::DeviceSize stagingHead = 0u;
+    vk::DeviceSize stagingTail = 0u;
+    // stagingHead at the last submit; the open batch uses everything after
+    vk::DeviceSize submittedHead = 0u;
+
+    uint64_t submittedValue = 0u;
+    uint64_t acquiredValue  = 0u;
+
+    std::optional<Batch> openBatch;
+    Acquires             openAcquires;
+
+    // submitted, not yet completed, oldest first
+    std::deque<Batch> inFlight;
+
+    // submitted, not yet acquired by the graphics family
+    Acquires pendingAcquires;
+
+    [[nodiscard]]
+    auto dedicatedFamily() const -> bool
+    {
+        return srcFamily != dstFamily;
+    }
+
+    // Reserve between minSize and maxSize bytes (a multiple of unit) of
+    // contiguous staging space, submitting and waiting for batches as needed.
+    [[nodiscard]]
+    auto reserveStaging(
+        vk::DeviceSize minSize,
+        vk::DeviceSize maxSize,
+        vk::DeviceSize unit,
+        vk::DeviceSize alignment) -> StagingChunk;
+
+    auto flushStaging(const StagingChunk &chunk) const -> void;
+};
@@ -1,7 +1,16 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <span>
+#include <type_traits>
+
 #include <vulkan/vulkan_raii.hpp>
 
+#include "Texture.hpp"
+
 #ifdef NDEBUG
 #define VK_CHECK(vkFnc) vkFnc
 #else
@@ -19,3 +28,45 @@
 #endif
 
 auto findDepthFormat(vk::raii::PhysicalDevice &physicalDevice) -> vk::Format;
+
+// Which block-compressed texture formats physicalDevice can sample.
+auto queryTextureFormatSupport(vk::raii::PhysicalDevice &physicalDevice)
+    -> TextureFormatSupport;
+
+// Incremental 64-bit FNV-1a. Cheap checksum for cache files and stamps;
+// catches truncation and bit rot, not tampering.
+struct Fnv1aHasher {
+    std::uint64_t value = 14695981039346656037ull;
+
+    auto add(std::span<const std::byte> bytes) -> void
+    {
+        for (const std::byte byte : bytes) {
+            value ^= static_cast<std::uint64_t>(byte);
+            value *= 1099511628211ull;
+        }
+    }
+
+    template <typename T>
+    auto add(const T &element) -> void
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        add(std::as_bytes(std::span{&element, 1u}));
+    }
+};
+
+[[nodiscard]]
+inline auto fnv1a(std::span<const std::byte> bytes) -> std::uint64_t
+{
+    Fnv1aHasher hasher{};
+    hasher.add(bytes);
+
+    return hasher.value;
+}
+
+// Write chunks, in order, to a sibling "<path>.tmp" and rename it over path,
+// so a crash or a concurrent reader never observes a half-written file.
+// Throws std::runtime_error or std::filesystem::filesystem_error on failure.
+auto writeFileAtomically(
+    const std::filesystem::path                       &path,
+    std::initializer_list<std::span<const std::byte>> chunks) -> void;
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include <glm/glm.hpp>
+
+// Encoders for the packed MeshVertex attributes.
+
+// Octahedral normal plus the tangent as an angle around it. tangent.w is
+// the bitangent sign; without a tangent only the normal is stored.
+[[nodiscard]]
+auto packNormalTangent(
+    glm::vec3                normal,
+    std::optional<glm::vec4> tangent) -> std::array<std::int16_t, 4>;
+
+// The normal as decoded on the GPU (unit length).
+[[nodiscard]]
+auto unpackNormal(const std::array<std::int16_t, 4> &normalTangent) -> glm::vec3;
+
+[[nodiscard]]
+auto packHalf2(glm::vec2 value) -> std::uint32_t;
+
+[[nodiscard]]
+auto packUnorm2x16(glm::vec2 value) -> std::uint32_t;
+
+[[nodiscard]]
+auto packSnorm2x16(glm::vec2 value) -> std::uint32_t;
+
+[[nodiscard]]
+auto packUnorm4(glm::vec4 value) -> std::uint32_t;
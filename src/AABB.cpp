@@ -127,13 +127,13 @@ auto computeWorldAABBFromLocalAABB(
 auto computeLocalAABB(const Submesh &submesh) -> AABB
 {
     // Bounds from vertex positions only.
-    if (submesh.vertices.empty()) {
+    if (submesh.vertexCount() == 0u) {
         return AABB::invalid();
     }
 
     auto localAABB = AABB::invalid();
 
-    for (const auto &vertex : submesh.vertices) {
+    for (const auto &vertex : submesh.vertexData()) {
         // Expand AABB to enclose each vertex
         localAABB.min = glm::min(localAABB.min, vertex.position);
         localAABB.max = glm::max(localAABB.max, vertex.position);
@@ -108,6 +108,7 @@ auto Allocator::createBuffer(
         &allocationInfo));
 
     buffer.buffer = vk_buffer;
+    buffer.size   = bufferSize;
 
     if (isStagingBuffer) {
         stagingBuffers.push_back(buffer);
@@ -0,0 +1,597 @@
+#include "BlockCompression.hpp"
+
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr std::uint32_t kBlockDim    = 4u;
+constexpr std::uint32_t kBlockTexels = kBlockDim * kBlockDim;
+constexpr std::uint32_t kChannels    = 4u;
+
+// block rows encoded per worker task; small enough that one large image
+// still spreads over every worker
+constexpr std::uint32_t kBlockRowsPerTask = 8u;
+
+// how materials read an image
+constexpr std::uint32_t kUseNormal = 1u << 0u;
+constexpr std::uint32_t kUseRed    = 1u << 1u;
+constexpr std::uint32_t kUseOther  = 1u << 2u;
+
+// BC7 4-bit index interpolation weights (out of 64)
+constexpr std::array<int, 16> kWeights4 =
+    {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// one 4x4 block, RGBA8, row-major
+using BlockTexels = std::array<std::uint8_t, kBlockTexels * kChannels>;
+
+using Endpoints = std::array<std::array<float, kChannels>, 2>;
+
+// Little-endian bit packer for one 128-bit block.
+struct BlockBits {
+    std::uint64_t low      = 0u;
+    std::uint64_t high     = 0u;
+    std::uint32_t position = 0u;
+
+    auto put(
+        std::uint32_t value,
+        std::uint32_t bitCount) -> void
+    {
+        const std::uint64_t bits = value;
+
+        if (position < 64u) {
+            low |= bits << position;
+
+            if (position + bitCount > 64u) {
+                high |= bits >> (64u - position);
+            }
+        } else {
+            high |= bits << (position - 64u);
+        }
+
+        position += bitCount;
+    }
+
+    auto store(std::byte *out) const -> void
+    {
+        for (std::uint32_t byte = 0u; byte < 8u; ++byte) {
+            out[byte]      = static_cast<std::byte>(low >> (byte * 8u));
+            out[byte + 8u] = static_cast<std::byte>(high >> (byte * 8u));
+        }
+    }
+};
+
+// Edge blocks of sizes that are not a multiple of 4 repeat the last
+// row/column, which the decoder never shows.
+[[nodiscard]]
+auto loadBlock(
+    const std::byte *level,
+    vk::Extent2D     extent,
+    std::uint32_t    blockX,
+    std::uint32_t    blockY) -> BlockTexels
+{
+    BlockTexels texels{};
+
+    for (std::uint32_t y = 0u; y < kBlockDim; ++y) {
+        const std::uint32_t sourceY = std::min(blockY * kBlockDim + y, extent.height - 1u);
+
+        for (std::uint32_t x = 0u; x < kBlockDim; ++x) {
+            const std::uint32_t sourceX =
+                std::min(blockX * kBlockDim + x, extent.width - 1u);
+
+            std::memcpy(
+                &texels[(y * kBlockDim + x) * kChannels],
+                level + (static_cast<std::size_t>(sourceY) * extent.width + sourceX) * kChannels,
+                kChannels);
+        }
+    }
+
+    return texels;
+}
+
+// BC4: two 8-bit endpoints, 3-bit indices. Always uses the 8-value mode
+// (red0 > red1) spanning the block's range.
+auto encodeBc4(
+    const BlockTexels &texels,
+    std::uint32_t      channel,
+    std::byte         *out) -> void
+{
+    int high = 0;
+    int low  = 255;
+
+    for (std::uint32_t texel = 0u; texel < kBlockTexels; ++texel) {
+        const int value = texels[texel * kChannels + channel];
+
+        high = std::max(high, value);
+        low  = std::min(low, value);
+    }
+
+    std::array<int, 8> palette{high, low};
+
+    for (int code = 2; code < 8; ++code) {
+        palette[code] = ((8 - code) * high + (code - 1) * low + 3) / 7;
+    }
+
+    std::uint64_t indices = 0u;
+
+    for (std::uint32_t texel = 0u; texel < kBlockTexels; ++texel) {
+        const int value = texels[texel * kChannels + channel];
+
+        std::uint64_t bestCode  = 0u;
+        int           bestError = std::numeric_limits<int>::max();
+
+        for (std::uint32_t code = 0u; code < palette.size(); ++code) {
+            const int error = std::abs(palette[code] - value);
+
+            if (error < bestError) {
+                bestError = error;
+                bestCode  = code;
+            }
+        }
+
+        indices |= bestCode << (texel * 3u);
+    }
+
+    out[0] = static_cast<std::byte>(high);
+    out[1] = static_cast<std::byte>(low);
+
+    for (std::uint32_t byte = 0u; byte < 6u; ++byte) {
+        out[2u + byte] = static_cast<std::byte>(indices >> (byte * 8u));
+    }
+}
+
+struct Mode6Fit {
+    // 7-bit endpoint components and their shared-LSB p-bits
+    std::array<std::array<std::uint32_t, kChannels>, 2> endpoints{};
+    std::array<std::uint32_t, 2>                         pBits{};
+
+    std::array<std::uint32_t, kBlockTexels> indices{};
+
+    std::uint64_t error = std::numeric_limits<std::uint64_t>::max();
+};
+
+// Endpoints at the extremes of the block along its principal axis.
+[[nodiscard]]
+auto principalEndpoints(const BlockTexels &texels) -> Endpoints
+{
+    std::array<float, kChannels> mean{};
+    std::array<float, kChannels> low{255.0f, 255.0f, 255.0f, 255.0f};
+    std::array<float, kChannels> high{};
+
+    for (std::uint32_t texel = 0u; texel < kBlockTexels; ++texel) {
+        for (std::uint32_t c = 0u; c < kChannels; ++c) {
+            const float value = texels[texel * kChannels + c];
+
+            mean[c] += value;
+            low[c] = std::min(low[c], value);
+            high[c] = std::max(high[c], value);
+        }
+    }
+
+    for (float &value : mean) {
+        value /= static_cast<float>(kBlockTexels);
+    }
+
+    std::array<std::array<float, kChannels>, kChannels> covariance{};
+
+    for (std::uint32_t texel = 0u; texel < kBlockTexels; ++texel) {
+        for (std::uint32_t row = 0u; row < kChannels; ++row) {
+            const float rowValue = texels[texel * kChannels + row] - mean[row];
+
+            for (std::uint32_t column = 0u; column < kChannels; ++column) {
+                covariance[row][column] +=
+                    rowValue * (texels[texel * kChannels + column] - mean[column]);
+            }
+        }
+    }
+
+    // power iteration from the bounding-box diagonal
+    std::array<float, kChannels> axis{};
+
+    for (std::uint32_t c = 0u; c < kChannels; ++c) {
+        axis[c] = high[c] - low[c];
+    }
+
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        std::array<float, kChannels> next{};
+        float                        lengthSquared = 0.0f;
+
+        for (std::uint32_t row = 0u; row < kChannels; ++row) {
+            for (std::uint32_t column = 0u; column < kChannels; ++column) {
+                next[row] += covariance[row][column] * axis[column];
+            }
+
+            lengthSquared += next[row] * next[row];
+        }
+
+        if (lengthSquared < 1e-12f) {
+            break;
+        }
+
+        const float inverseLength = 1.0f / std::sqrt(lengthSquared);
+
+        for (std::uint32_t c = 0u; c < kChannels; ++c) {
+            axis[c] = next[c] * inverseLength;
+        }
+    }
+
+    float minProjection = 0.0f;
+    float maxProjection = 0.0f;
+
+    for (std::uint32_t texel = 0u; texel < kBlockTexels; ++texel) {
+        float projection = 0.0f;
+
+        for (std::uint32_t c = 0u; c < kChannels; ++c) {
+            projection += (texels[texel * kChannels + c] - mean[c]) * axis[c];
+        }
+
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+
+    Endpoints endpoints{};
+
+    for (std::uint32_t c = 0u; c < kChannels; ++c) {
+        endpoints[0][c] = std::clamp(mean[c] + minProjection * axis[c], 0.0f, 255.0f);
+        endpoints[1][c] = std::clamp(mean[c] + maxProjection * axis[c], 0.0f, 255.0f);
+    }
+
+    return endpoints;
+}
+
+// Quantize endpoints with each p-bit pair, assign indices, and keep the
+// result in best if it has lower squared error.
+auto fitMode6(
+    const BlockTexels &texels,
+    const Endpoints   &endpoints,
+    Mode6Fit          &best) -> void
+{
+    for (std::uint32_t p0 = 0u; p0 < 2u; ++p0) {
+        for (std::uint32_t p1 = 0u; p1 < 2u; ++p1) {
+            Mode6Fit fit{};
+            fit.pBits = {p0, p1};
+
+            std::array<std::array<int, kChannels>, 2> expanded{};
+
+            for (std::uint32_t end = 0u; end < 2u; ++end) {
+                const std::uint32_t pBit = fit.pBits[end];
+
+                for (std::uint32_t c = 0u; c < kChannels; ++c) {
+                    const auto quantized = static_cast<std::uint32_t>(std::clamp(
+                        std::lround((endpoints[end][c] - static_cast<float>(pBit)) * 0.5f),
+                        0l,
+                        127l));
+
+                    fit.endpoints[end][c] = quantized;
+                    expanded[end][c]      = static_cast<int>((quantized << 1u) | pBit);
+                }
+            }
+
+            std::array<std::array<int, kChannels>, kWeights4.size()> palette{};
+
+            for (std::size_t index = 0u; index < kWeights4.size(); ++index) {
+                for (std::uint32_t c = 0u; c < kChannels; ++c) {
+                    palette[index][c] = ((64 - kWeights4[index]) * expanded[0][c]
+                                         + kWeights4[index] * expanded[1][c] + 32)
+                                     >> 6;
+                }
+            }
+
+            std::array<int, kChannels> direction{};
+            int                        directionSquared = 0;
+
+            for (std::uint32_t c = 0u; c < kChannels; ++c) {
+                direction[c] = expanded[1][c] - expanded[0][c];
+                directionSquared += direction[c] * direction[c];
+            }
+
+            fit.error = 0u;
+
+            for (std::uint32_t texel = 0u; texel < kBlockTexels; ++texel) {
+                const std::uint8_t *value = &texels[texel * kChannels];
+
+                // project onto the endpoint line, then settle between the
+                // neighbouring palette entries
+                int guess = 0;
+
+                if (directionSquared > 0) {
+                    int dot = 0;
+
+                    for (std::uint32_t c = 0u; c < kChannels; ++c) {
+                        dot += (value[c] - expanded[0][c]) * direction[c];
+                    }
+
+                    guess = std::clamp(
+                        static_cast<int>(std::lround(
+                            15.0f * static_cast<float>(dot)
+                            / static_cast<float>(directionSquared))),
+                        0,
+                        15);
+                }
+
+                std::uint32_t bestIndex = 0u;
+                int           bestError = std::numeric_limits<int>::max();
+
+                for (int index = std::max(guess - 1, 0); index <= std::min(guess + 1, 15);
+                     ++index) {
+                    int error = 0;
+
+                    for (std::uint32_t c = 0u; c < kChannels; ++c) {
+                        const int delta = palette[index][c] - value[c];
+                        error += delta * delta;
+                    }
+
+                    if (error < bestError) {
+                        bestError = error;
+                        bestIndex = static_cast<std::uint32_t>(index);
+                    }
+                }
+
+                fit.indices[texel] = bestIndex;
+                fit.error += static_cast<std::uint64_t>(bestError);
+            }
+
+            if (fit.error < best.error) {
+                best = fit;
+            }
+        }
+    }
+}
+
+// Least-squares endpoints for a fixed index assignment; nullopt when every
+// texel uses the same weight.
+[[nodiscard]]
+auto refineEndpoints(
+    const BlockTexels                             &texels,
+    const std::array<std::uint32_t, kBlockTexels> &indices) -> std::optional<Endpoints>
+{
+    float aa = 0.0f;
+    float ab = 0.0f;
+    float bb = 0.0f;
+
+    std::array<float, kChannels> ax{};
+    std::array<float, kChannels> bx{};
+
+    for (std::uint32_t texel = 0u; texel < kBlockTexels; ++texel) {
+        const float b = static_cast<float>(kWeights4[indices[texel]]) / 64.0f;
+        const float a = 1.0f - b;
+
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+
+        for (std::uint32_t c = 0u; c < kChannels; ++c) {
+            ax[c] += a * texels[texel * kChannels + c];
+            bx[c] += b * texels[texel * kChannels + c];
+        }
+    }
+
+    const float determinant = aa * bb - ab * ab;
+
+    if (std::abs(determinant) < 1e-6f) {
+        return std::nullopt;
+    }
+
+    Endpoints endpoints{};
+
+    for (std::uint32_t c = 0u; c < kChannels; ++c) {
+        endpoints[0][c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+        endpoints[1][c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+    }
+
+    return endpoints;
+}
+
+// BC7 mode 6: one subset, RGBA 7.7.7.7 endpoints with a p-bit each, 4-bit
+// indices. A single mode keeps the encoder simple and is a good fit for
+// smooth colour and alpha.
+auto encodeBc7(
+    const BlockTexels &texels,
+    std::byte         *out) -> void
+{
+    Mode6Fit fit{};
+    fitMode6(texels, principalEndpoints(texels), fit);
+
+    if (const auto refined = refineEndpoints(texels, fit.indices)) {
+        fitMode6(texels, *refined, fit);
+    }
+
+    // the anchor (first) index is stored without its top bit
+    if (fit.indices[0] >= 8u) {
+        std::swap(fit.endpoints[0], fit.endpoints[1]);
+        std::swap(fit.pBits[0], fit.pBits[1]);
+
+        for (std::uint32_t &index : fit.indices) {
+            index = 15u - index;
+        }
+    }
+
+    BlockBits bits{};
+
+    bits.put(1u << 6u, 7u);
+
+    for (std::uint32_t c = 0u; c < kChannels; ++c) {
+        bits.put(fit.endpoints[0][c], 7u);
+        bits.put(fit.endpoints[1][c], 7u);
+    }
+
+    bits.put(fit.pBits[0], 1u);
+    bits.put(fit.pBits[1], 1u);
+
+    bits.put(fit.indices[0], 3u);
+
+    for (std::uint32_t texel = 1u; texel < kBlockTexels; ++texel) {
+        bits.put(fit.indices[texel], 4u);
+    }
+
+    bits.store(out);
+}
+
+auto encodeBlock(
+    vk::Format         format,
+    const BlockTexels &texels,
+    std::byte         *out) -> void
+{
+    switch (format) {
+    case vk::Format::eBc4UnormBlock:
+        encodeBc4(texels, 0u, out);
+        break;
+    case vk::Format::eBc5UnormBlock:
+        encodeBc4(texels, 0u, out);
+        encodeBc4(texels, 1u, out + 8u);
+        break;
+    default:
+        encodeBc7(texels, out);
+        break;
+    }
+}
+
+// Which channels each image is read through, over every material slot.
+[[nodiscard]]
+auto imageUsage(const RenderAsset &asset) -> std::vector<std::uint32_t>
+{
+    std::vector<std::uint32_t> usage(asset.images.size(), 0u);
+
+    const auto mark = [&](const TextureRef &textureRef, std::uint32_t use) {
+        usage[asset.textures[textureRef.textureIndex].imageIndex] |= use;
+    };
+
+    for (const Material &material : asset.materials) {
+        mark(material.core.baseColorTexture, kUseOther);
+        mark(material.core.metallicRoughnessTexture, kUseOther);
+        mark(material.core.normalTexture, kUseNormal);
+        mark(material.core.occlusionTexture, kUseRed);
+        mark(material.core.emissiveTexture, kUseOther);
+
+        // specular strength is in alpha
+        mark(material.specular.specularTexture, kUseOther);
+        mark(material.specular.specularColorTexture, kUseOther);
+
+        // clearcoat roughness is in green
+        mark(material.clearcoat.clearcoatTexture, kUseRed);
+        mark(material.clearcoat.clearcoatRoughnessTexture, kUseOther);
+        mark(material.clearcoat.clearcoatNormalTexture, kUseNormal);
+    }
+
+    return usage;
+}
+
+// eUndefined when the device can sample none of the candidates.
+[[nodiscard]]
+auto compressedFormat(std::uint32_t usage, const TextureFormatSupport &formats)
+    -> vk::Format
+{
+    if (usage == kUseNormal && formats.bc5) {
+        return vk::Format::eBc5UnormBlock;
+    }
+
+    if (usage == kUseRed && formats.bc4) {
+        return vk::Format::eBc4UnormBlock;
+    }
+
+    if (formats.bc7) {
+        return vk::Format::eBc7UnormBlock;
+    }
+
+    return vk::Format::eUndefined;
+}
+
+struct EncodeTask {
+    std::uint32_t slot          = 0u;
+    std::uint32_t level         = 0u;
+    std::uint32_t firstBlockRow = 0u;
+    std::uint32_t blockRowCount = 0u;
+};
+
+} // namespace
+
+auto compressTextures(RenderAsset &asset, const TextureFormatSupport &formats) -> void
+{
+    const auto usage = imageUsage(asset);
+
+    std::vector<std::size_t>  sourceIndices{};
+    std::vector<TextureImage> compressed{};
+    std::vector<EncodeTask>   tasks{};
+
+    for (std::size_t imageIndex = 0u; imageIndex < asset.images.size(); ++imageIndex) {
+        const TextureImage &image = asset.images[imageIndex];
+
+        if (image.format != vk::Format::eR8G8B8A8Unorm || image.extent.width < kBlockDim
+            || image.extent.height < kBlockDim) {
+            continue;
+        }
+
+        const vk::Format format = compressedFormat(usage[imageIndex], formats);
+
+        if (format == vk::Format::eUndefined) {
+            continue;
+        }
+
+        TextureImage result{};
+        result.format    = format;
+        result.extent    = image.extent;
+        result.mipLevels = image.mipLevels;
+        result.data.resize(result.levelOffset(result.mipLevels));
+
+        const auto slot = static_cast<std::uint32_t>(compressed.size());
+
+        for (std::uint32_t level = 0u; level < image.mipLevels; ++level) {
+            const vk::Extent2D  extent = mipLevelExtent(image.extent, level);
+            const std::uint32_t blockRows = (extent.height + kBlockDim - 1u) / kBlockDim;
+
+            for (std::uint32_t row = 0u; row < blockRows; row += kBlockRowsPerTask) {
+                tasks.push_back(EncodeTask{
+                    .slot          = slot,
+                    .level         = level,
+                    .firstBlockRow = row,
+                    .blockRowCount = std::min(kBlockRowsPerTask, blockRows - row),
+                });
+            }
+        }
+
+        sourceIndices.push_back(imageIndex);
+        compressed.push_back(std::move(result));
+    }
+
+    // Every task writes its own block rows of a pre-sized level.
+    parallelFor(tasks.size(), [&](std::size_t taskIndex) {
+        const EncodeTask   &task   = tasks[taskIndex];
+        const TextureImage &source = asset.images[sourceIndices[task.slot]];
+        TextureImage       &target = compressed[task.slot];
+
+        const vk::Extent2D  extent       = mipLevelExtent(source.extent, task.level);
+        const std::uint32_t blockColumns = (extent.width + kBlockDim - 1u) / kBlockDim;
+        const std::size_t   blockBytes   = vk::blockSize(target.format);
+
+        const std::byte *texels = source.data.data() + source.levelOffset(task.level);
+
+        std::byte *out = target.data.data() + target.levelOffset(task.level)
+                       + static_cast<std::size_t>(task.firstBlockRow) * blockColumns
+                             * blockBytes;
+
+        for (std::uint32_t row = task.firstBlockRow;
+             row < task.firstBlockRow + task.blockRowCount;
+             ++row) {
+            for (std::uint32_t column = 0u; column < blockColumns; ++column) {
+                encodeBlock(target.format, loadBlock(texels, extent, column, row), out);
+                out += blockBytes;
+            }
+        }
+    });
+
+    for (std::size_t slot = 0u; slot < compressed.size(); ++slot) {
+        asset.images[sourceIndices[slot]] = std::move(compressed[slot]);
+    }
+}
@@ -0,0 +1,957 @@
+#include "CookedAsset.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <variant>
+
+#include "MappedFile.hpp"
+#include "Utility.hpp"
+
+namespace
+{
+
+template <class... Ts> struct overloads : Ts... {
+    using Ts::operator()...;
+};
+
+constexpr auto kCookedMagic = std::array{'N', 'I', 'E', 'N', 'C', 'O', 'O', 'K'};
+
+// Section payloads start on cache-line boundaries so blobs can be handed to
+// staging copies straight from the mapping.
+constexpr std::uint64_t kSectionAlignment = 64u;
+
+constexpr std::uint32_t kNoIndex = std::numeric_limits<std::uint32_t>::max();
+
+enum class SectionId : std::uint32_t {
+    kAsset,
+    kSourceFiles,
+    kSourceFileChars,
+    kScenes,
+    kSceneRoots,
+    kNodes,
+    kNodeChildren,
+    kMeshes,
+    kSubmeshes,
+    kVertices,
+    kIndices,
+    kMaterials,
+    kTextures,
+    kImages,
+    kImagePayload,
+    kCameras,
+
+    kCount,
+};
+
+constexpr auto kSectionCount = static_cast<std::uint32_t>(SectionId::kCount);
+
+struct CookedHeader {
+    std::array<char, 8> magic{};
+
+    std::uint32_t version      = 0u;
+    std::uint32_t sectionCount = 0u;
+
+    std::uint64_t sourceStamp = 0u;
+    std::uint64_t fileSize    = 0u;
+};
+
+struct CookedSection {
+    std::uint32_t elementSize  = 0u;
+    std::uint32_t elementCount = 0u;
+    std::uint64_t offset       = 0u;
+};
+
+struct AssetRecord {
+    std::uint32_t activeScene = 0u;
+    std::uint32_t _pad0       = 0u;
+};
+
+struct SourceFileRecord {
+    std::uint32_t firstChar = 0u;
+    std::uint32_t charCount = 0u;
+};
+
+struct SceneRecord {
+    std::uint32_t firstRoot = 0u;
+    std::uint32_t rootCount = 0u;
+};
+
+struct NodeRecord {
+    glm::vec3 translation{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 scale{1.0f};
+
+    std::uint32_t meshIndex   = kNoIndex;
+    std::uint32_t cameraIndex = kNoIndex;
+
+    std::uint32_t firstChild = 0u;
+    std::uint32_t childCount = 0u;
+};
+
+struct MeshRecord {
+    std::uint32_t firstSubmesh = 0u;
+    std::uint32_t submeshCount = 0u;
+};
+
+// Indices are stored at submeshIndexType() width, so they upload without
+// conversion; firstIndexByte is a byte offset into the index section.
+// maxIndex lets the reader bounds-check a submesh without walking it.
+struct SubmeshRecord {
+    std::uint64_t firstVertex    = 0u;
+    std::uint64_t firstIndexByte = 0u;
+
+    std::uint32_t vertexCount = 0u;
+    std::uint32_t indexCount  = 0u;
+
+    std::uint32_t materialIndex = 0u;
+    std::uint32_t topology      = 0u;
+    std::uint32_t tangentsValid = 0u;
+    std::uint32_t maxIndex      = 0u;
+
+    std::uint32_t uvEncoding = 0u;
+    std::uint32_t _pad0      = 0u;
+};
+
+struct TextureRecord {
+    std::uint32_t imageIndex = 0u;
+    std::uint32_t _pad0      = 0u;
+
+    // pNext is cleared on write and on read.
+    vk::SamplerCreateInfo samplerInfo{};
+};
+
+struct ImageRecord {
+    std::uint32_t width     = 0u;
+    std::uint32_t height    = 0u;
+    std::uint32_t mipLevels = 1u;
+    std::uint32_t format    = 0u; // vk::Format
+
+    std::uint64_t payloadOffset = 0u;
+    std::uint64_t payloadSize   = 0u;
+};
+
+enum class CameraKind : std::uint32_t {
+    kPerspective,
+    kOrthographic,
+};
+
+constexpr std::uint32_t kCameraHasAspectRatio = 1u << 0u;
+constexpr std::uint32_t kCameraHasZfar        = 1u << 1u;
+
+struct CameraRecord {
+    CameraKind    kind  = CameraKind::kPerspective;
+    std::uint32_t flags = 0u;
+
+    float yfov        = 0.0f;
+    float aspectRatio = 0.0f;
+    float xmag        = 0.0f;
+    float ymag        = 0.0f;
+    float znear       = 0.0f;
+    float zfar        = 0.0f;
+};
+
+static_assert(std::is_trivially_copyable_v<MeshVertex>);
+static_assert(std::is_trivially_copyable_v<Material>);
+static_assert(std::is_trivially_copyable_v<NodeRecord>);
+static_assert(std::is_trivially_copyable_v<TextureRecord>);
+
+[[nodiscard]]
+constexpr auto alignUp(
+    std::uint64_t value,
+    std::uint64_t alignment) -> std::uint64_t
+{
+    return (value + alignment - 1u) / alignment * alignment;
+}
+
+// Stamp of the cooked version, the content key and the path, size and write
+// time of every source file. Source contents are not read: like make, an
+// edit that keeps both size and write time goes unnoticed. Returns nullopt
+// if a source file is missing.
+[[nodiscard]]
+auto computeSourceStamp(
+    const std::filesystem::path              &sourceDirectory,
+    const std::vector<std::filesystem::path> &sourceFiles,
+    std::uint64_t contentKey) -> std::optional<std::uint64_t>
+{
+    Fnv1aHasher hasher{};
+
+    hasher.add(kCookedAssetVersion);
+    hasher.add(contentKey);
+
+    for (const auto &sourceFile : sourceFiles) {
+        const auto path = sourceDirectory / sourceFile;
+
+        std::error_code error{};
+
+        const auto fileSize = std::filesystem::file_size(path, error);
+
+        if (error) {
+            return std::nullopt;
+        }
+
+        const auto writeTime = std::filesystem::last_write_time(path, error);
+
+        if (error) {
+            return std::nullopt;
+        }
+
+        const std::string name = sourceFile.generic_string();
+
+        hasher.add(std::as_bytes(std::span{name}));
+        hasher.add(static_cast<std::uint64_t>(fileSize));
+        hasher.add(static_cast<std::int64_t>(writeTime.time_since_epoch().count()));
+    }
+
+    return hasher.value;
+}
+
+class CookedWriter
+{
+  public:
+    template <typename T>
+    auto addSection(
+        SectionId          id,
+        std::span<const T> elements) -> void
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        if (elements.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error("cooked section too large");
+        }
+
+        const std::uint64_t offset = alignUp(payload.size(), kSectionAlignment);
+
+        payload.resize(static_cast<std::size_t>(offset) + elements.size_bytes());
+
+        if (!elements.empty()) {
+            std::memcpy(
+                payload.data() + offset,
+                elements.data(),
+                elements.size_bytes());
+        }
+
+        sections[static_cast<std::size_t>(id)] = CookedSection{
+            .elementSize  = static_cast<std::uint32_t>(sizeof(T)),
+            .elementCount = static_cast<std::uint32_t>(elements.size()),
+            .offset       = offset,
+        };
+    }
+
+    auto write(
+        const std::filesystem::path &path,
+        std::uint64_t                sourceStamp) -> void
+    {
+        const std::uint64_t payloadBase = alignUp(
+            sizeof(CookedHeader) + sizeof(CookedSection) * kSectionCount,
+            kSectionAlignment);
+
+        for (auto &section : sections) {
+            section.offset += payloadBase;
+        }
+
+        const CookedHeader header{
+            .magic        = kCookedMagic,
+            .version      = kCookedAssetVersion,
+            .sectionCount = kSectionCount,
+            .sourceStamp  = sourceStamp,
+            .fileSize     = payloadBase + payload.size(),
+        };
+
+        std::vector<std::byte> prefix(static_cast<std::size_t>(payloadBase));
+
+        std::memcpy(prefix.data(), &header, sizeof(header));
+        std::memcpy(
+            prefix.data() + sizeof(header),
+            sections.data(),
+            sizeof(CookedSection) * kSectionCount);
+
+        writeFileAtomically(path, {std::span{prefix}, std::span{payload}});
+    }
+
+  private:
+    std::array<CookedSection, kSectionCount> sections{};
+    std::vector<std::byte>                   payload;
+};
+
+class CookedReader
+{
+  public:
+    explicit CookedReader(std::span<const std::byte> bytes_)
+        : bytes{bytes_}
+    {
+    }
+
+    // Validates the header and section table against the file size.
+    [[nodiscard]]
+    auto readHeader() -> bool
+    {
+        if (bytes.size() < sizeof(CookedHeader) + sizeof(sections)) {
+            return false;
+        }
+
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        if (header.magic != kCookedMagic || header.version != kCookedAssetVersion
+            || header.sectionCount != kSectionCount
+            || header.fileSize != bytes.size()) {
+            return false;
+        }
+
+        std::memcpy(sections.data(), bytes.data() + sizeof(header), sizeof(sections));
+
+        for (const auto &section : sections) {
+            const std::uint64_t sectionSize =
+                static_cast<std::uint64_t>(section.elementSize) * section.elementCount;
+
+            if (section.offset > bytes.size()
+                || bytes.size() - section.offset < sectionSize) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    [[nodiscard]]
+    auto sourceStamp() const -> std::uint64_t
+    {
+        return header.sourceStamp;
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    auto readSection(SectionId id) const -> std::vector<T>
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        const CookedSection &section = sections[static_cast<std::size_t>(id)];
+
+        if (section.elementSize != sizeof(T)) {
+            throw std::runtime_error("cooked section layout mismatch");
+        }
+
+        std::vector<T> elements(section.elementCount);
+
+        if (!elements.empty()) {
+            std::memcpy(
+                elements.data(),
+                bytes.data() + section.offset,
+                sizeof(T) * elements.size());
+        }
+
+        return elements;
+    }
+
+    // Payload sections are read in place; the reader's bytes must outlive
+    // the returned span. Sections are 64-byte aligned in a page-aligned
+    // mapping, so any record type can be viewed directly.
+    template <typename T>
+    [[nodiscard]]
+    auto sectionView(SectionId id) const -> std::span<const T>
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        static_assert(alignof(T) <= kSectionAlignment);
+
+        const CookedSection &section = sections[static_cast<std::size_t>(id)];
+
+        if (section.elementSize != sizeof(T)) {
+            throw std::runtime_error("cooked section layout mismatch");
+        }
+
+        return std::span{
+            reinterpret_cast<const T *>(bytes.data() + section.offset),
+            section.elementCount};
+    }
+
+    [[nodiscard]]
+    auto sectionBytes(SectionId id) const -> std::span<const std::byte>
+    {
+        return sectionView<std::byte>(id);
+    }
+
+  private:
+    std::span<const std::byte> bytes;
+
+    CookedHeader                             header{};
+    std::array<CookedSection, kSectionCount> sections{};
+};
+
+// Returns elements[first, first + count), or throws if out of range.
+template <typename T>
+[[nodiscard]]
+auto checkedRange(
+    std::span<const T> elements,
+    std::uint64_t      first,
+    std::uint64_t      count) -> std::span<const T>
+{
+    if (first > elements.size() || elements.size() - first < count) {
+        throw std::runtime_error("cooked range out of bounds");
+    }
+
+    return elements.subspan(
+        static_cast<std::size_t>(first),
+        static_cast<std::size_t>(count));
+}
+
+template <typename T>
+[[nodiscard]]
+auto checkedRange(
+    const std::vector<T> &elements,
+    std::uint64_t         first,
+    std::uint64_t         count) -> std::span<const T>
+{
+    return checkedRange(std::span<const T>{elements}, first, count);
+}
+
+auto checkIndex(
+    std::uint32_t index,
+    std::size_t   count) -> void
+{
+    if (index >= count) {
+        throw std::runtime_error("cooked index out of bounds");
+    }
+}
+
+// Largest index of a GPU-width index stream; 0 when it is empty.
+[[nodiscard]]
+auto maxIndex(
+    std::span<const std::byte> indexBytes,
+    vk::IndexType              indexType) -> std::uint32_t
+{
+    std::uint32_t result = 0u;
+
+    if (indexType == vk::IndexType::eUint16) {
+        for (std::size_t offset = 0u; offset < indexBytes.size(); offset += 2u) {
+            std::uint16_t index = 0u;
+            std::memcpy(&index, indexBytes.data() + offset, sizeof(index));
+            result = std::max<std::uint32_t>(result, index);
+        }
+    } else {
+        for (std::size_t offset = 0u; offset < indexBytes.size(); offset += 4u) {
+            std::uint32_t index = 0u;
+            std::memcpy(&index, indexBytes.data() + offset, sizeof(index));
+            result = std::max(result, index);
+        }
+    }
+
+    return result;
+}
+
+[[nodiscard]]
+auto readSourceFiles(const CookedReader &reader) -> std::vector<std::filesystem::path>
+{
+    const auto records = reader.readSection<SourceFileRecord>(SectionId::kSourceFiles);
+    const auto chars   = reader.readSection<char>(SectionId::kSourceFileChars);
+
+    std::vector<std::filesystem::path> sourceFiles{};
+    sourceFiles.reserve(records.size());
+
+    for (const SourceFileRecord &record : records) {
+        const auto name = checkedRange(chars, record.firstChar, record.charCount);
+
+        sourceFiles.emplace_back(std::string{name.begin(), name.end()});
+    }
+
+    return sourceFiles;
+}
+
+// Geometry and image payloads stay in the mapping; the asset shares
+// ownership of it through mappedStorage.
+[[nodiscard]]
+auto readAsset(
+    const CookedReader               &reader,
+    std::shared_ptr<const MappedFile> mappedFile) -> RenderAsset
+{
+    RenderAsset asset{};
+    asset.mappedStorage = std::move(mappedFile);
+
+    const auto assetRecords = reader.readSection<AssetRecord>(SectionId::kAsset);
+
+    if (assetRecords.size() != 1u) {
+        throw std::runtime_error("cooked asset record missing");
+    }
+
+    asset.activeScene = assetRecords.front().activeScene;
+
+    // Materials and images first; later records index into them.
+    asset.materials = reader.readSection<Material>(SectionId::kMaterials);
+
+    const auto imageRecords  = reader.readSection<ImageRecord>(SectionId::kImages);
+    const auto imagePayload  = reader.sectionBytes(SectionId::kImagePayload);
+    const auto imageBytesEnd = static_cast<std::uint64_t>(imagePayload.size());
+
+    asset.images.reserve(imageRecords.size());
+
+    for (const ImageRecord &record : imageRecords) {
+        if (record.payloadOffset > imageBytesEnd
+            || imageBytesEnd - record.payloadOffset < record.payloadSize) {
+            throw std::runtime_error("cooked image out of bounds");
+        }
+
+        const auto payload = imagePayload.subspan(
+            static_cast<std::size_t>(record.payloadOffset),
+            static_cast<std::size_t>(record.payloadSize));
+
+        TextureImage image{};
+        image.extent    = vk::Extent2D{record.width, record.height};
+        image.format    = static_cast<vk::Format>(record.format);
+        image.mipLevels = record.mipLevels;
+        image.mappedData = payload;
+
+        if (!image.isValid()) {
+            throw std::runtime_error("cooked image invalid");
+        }
+
+        asset.images.push_back(std::move(image));
+    }
+
+    const auto textureRecords = reader.readSection<TextureRecord>(SectionId::kTextures);
+
+    asset.textures.reserve(textureRecords.size());
+
+    for (const TextureRecord &record : textureRecords) {
+        checkIndex(record.imageIndex, asset.images.size());
+
+        Texture texture{};
+        texture.imageIndex        = record.imageIndex;
+        texture.samplerInfo       = record.samplerInfo;
+        texture.samplerInfo.pNext = nullptr;
+
+        asset.textures.push_back(texture);
+    }
+
+    const auto meshRecords    = reader.readSection<MeshRecord>(SectionId::kMeshes);
+    const auto submeshRecords =
+        reader.readSection<SubmeshRecord>(SectionId::kSubmeshes);
+    const auto vertices       = reader.sectionView<MeshVertex>(SectionId::kVertices);
+    const auto indexBytes     = reader.sectionBytes(SectionId::kIndices);
+
+    asset.meshes.reserve(meshRecords.size());
+
+    for (const MeshRecord &meshRecord : meshRecords) {
+        Mesh mesh{};
+        mesh.submeshes.reserve(meshRecord.submeshCount);
+
+        for (const SubmeshRecord &record : checkedRange(
+                 submeshRecords,
+                 meshRecord.firstSubmesh,
+                 meshRecord.submeshCount)) {
+
+            const auto submeshVertices =
+                checkedRange(vertices, record.firstVertex, record.vertexCount);
+
+            const std::uint64_t indexSize =
+                indexTypeForVertexCount(record.vertexCount) == vk::IndexType::eUint16
+                    ? sizeof(std::uint16_t)
+                    : sizeof(std::uint32_t);
+
+            if (record.firstIndexByte % indexSize != 0u) {
+                throw std::runtime_error("cooked indices misaligned");
+            }
+
+            const auto submeshIndices = checkedRange(
+                indexBytes,
+                record.firstIndexByte,
+                indexSize * record.indexCount);
+
+            if (record.indexCount != 0u) {
+                checkIndex(record.maxIndex, submeshVertices.size());
+            }
+
+            if (!asset.materials.empty()) {
+                checkIndex(record.materialIndex, asset.materials.size());
+            }
+
+            Submesh submesh{};
+            submesh.mappedVertices = submeshVertices;
+            submesh.mappedIndices  = submeshIndices;
+
+            submesh.materialIndex = record.materialIndex;
+            submesh.topology      = static_cast<vk::PrimitiveTopology>(record.topology);
+            submesh.tangentsValid = record.tangentsValid != 0u;
+            submesh.uvEncoding    = record.uvEncoding;
+
+            mesh.submeshes.push_back(std::move(submesh));
+        }
+
+        asset.meshes.push_back(std::move(mesh));
+    }
+
+    const auto cameraRecords = reader.readSection<CameraRecord>(SectionId::kCameras);
+
+    asset.cameras.reserve(cameraRecords.size());
+
+    for (const CameraRecord &record : cameraRecords) {
+        if (record.kind == CameraKind::kPerspective) {
+            PerspectiveCamera perspectiveCamera{};
+            perspectiveCamera.yfov  = record.yfov;
+            perspectiveCamera.znear = record.znear;
+
+            if ((record.flags & kCameraHasAspectRatio) != 0u) {
+                perspectiveCamera.aspectRatio = record.aspectRatio;
+            }
+
+            if ((record.flags & kCameraHasZfar) != 0u) {
+                perspectiveCamera.zfar = record.zfar;
+            }
+
+            asset.cameras.push_back(Camera{.model = perspectiveCamera});
+        }
+
+        else if (record.kind == CameraKind::kOrthographic) {
+            OrthographicCamera orthographicCamera{};
+            orthographicCamera.xmag  = record.xmag;
+            orthographicCamera.ymag  = record.ymag;
+            orthographicCamera.znear = record.znear;
+            orthographicCamera.zfar  = record.zfar;
+
+            asset.cameras.push_back(Camera{.model = orthographicCamera});
+        }
+
+        else {
+            throw std::runtime_error("cooked camera kind unknown");
+        }
+    }
+
+    const auto nodeRecords  = reader.readSection<NodeRecord>(SectionId::kNodes);
+    const auto nodeChildren =
+        reader.readSection<std::uint32_t>(SectionId::kNodeChildren);
+
+    asset.nodes.reserve(nodeRecords.size());
+
+    for (const NodeRecord &record : nodeRecords) {
+        SceneNode node{};
+        node.translation = record.translation;
+        node.rotation    = record.rotation;
+        node.scale       = record.scale;
+
+        if (record.meshIndex != kNoIndex) {
+            checkIndex(record.meshIndex, asset.meshes.size());
+            node.meshIndex = record.meshIndex;
+        }
+
+        if (record.cameraIndex != kNoIndex) {
+            checkIndex(record.cameraIndex, asset.cameras.size());
+            node.cameraIndex = record.cameraIndex;
+        }
+
+        for (const std::uint32_t childIndex :
+             checkedRange(nodeChildren, record.firstChild, record.childCount)) {
+            checkIndex(childIndex, nodeRecords.size());
+            node.childNodeIndices.push_back(childIndex);
+        }
+
+        asset.nodes.push_back(std::move(node));
+    }
+
+    const auto sceneRecords = reader.readSection<SceneRecord>(SectionId::kScenes);
+    const auto sceneRoots   = reader.readSection<std::uint32_t>(SectionId::kSceneRoots);
+
+    asset.scenes.reserve(sceneRecords.size());
+
+    for (const SceneRecord &record : sceneRecords) {
+        SceneRoots roots{};
+
+        for (const std::uint32_t rootIndex :
+             checkedRange(sceneRoots, record.firstRoot, record.rootCount)) {
+            checkIndex(rootIndex, asset.nodes.size());
+            roots.rootNodeIndices.push_back(rootIndex);
+        }
+
+        asset.scenes.push_back(std::move(roots));
+    }
+
+    if (!asset.scenes.empty()) {
+        checkIndex(asset.activeScene, asset.scenes.size());
+    }
+
+    return asset;
+}
+
+} // namespace
+
+auto defaultCookedAssetPath(const std::filesystem::path &gltfPath)
+    -> std::filesystem::path
+{
+    auto cookedPath = gltfPath;
+    cookedPath += ".cooked";
+
+    return cookedPath;
+}
+
+auto readCookedAsset(
+    const std::filesystem::path &cookedPath,
+    const std::filesystem::path &sourceDirectory,
+    std::uint64_t                contentKey) -> std::optional<RenderAsset>
+{
+    std::error_code error{};
+
+    if (!std::filesystem::is_regular_file(cookedPath, error)) {
+        return std::nullopt;
+    }
+
+    try {
+        auto mappedFile = std::make_shared<const MappedFile>(cookedPath);
+
+        CookedReader reader{mappedFile->bytes()};
+
+        if (!reader.readHeader()) {
+            return std::nullopt;
+        }
+
+        const auto sourceStamp =
+            computeSourceStamp(sourceDirectory, readSourceFiles(reader), contentKey);
+
+        if (!sourceStamp.has_value() || *sourceStamp != reader.sourceStamp()) {
+            return std::nullopt;
+        }
+
+        return readAsset(reader, std::move(mappedFile));
+    } catch (const std::exception &) {
+        // Unreadable or corrupt cooked files are treated as stale.
+        return std::nullopt;
+    }
+}
+
+auto writeCookedAsset(
+    const std::filesystem::path              &cookedPath,
+    const std::filesystem::path              &sourceDirectory,
+    const std::vector<std::filesystem::path> &sourceFiles,
+    std::uint64_t                             contentKey,
+    const RenderAsset                        &asset) -> void
+{
+    const auto sourceStamp = computeSourceStamp(sourceDirectory, sourceFiles, contentKey);
+
+    if (!sourceStamp.has_value()) {
+        throw std::runtime_error("cannot stat cooked asset sources");
+    }
+
+    CookedWriter writer{};
+
+    const auto assetRecord = AssetRecord{.activeScene = asset.activeScene};
+
+    writer.addSection(SectionId::kAsset, std::span{&assetRecord, 1u});
+
+    {
+        std::vector<SourceFileRecord> records{};
+        std::vector<char>             chars{};
+
+        for (const auto &sourceFile : sourceFiles) {
+            const std::string name = sourceFile.generic_string();
+
+            records.push_back(
+                SourceFileRecord{
+                    .firstChar = static_cast<std::uint32_t>(chars.size()),
+                    .charCount = static_cast<std::uint32_t>(name.size()),
+                });
+
+            chars.insert(chars.end(), name.begin(), name.end());
+        }
+
+        writer.addSection(SectionId::kSourceFiles, std::span{records});
+        writer.addSection(SectionId::kSourceFileChars, std::span{chars});
+    }
+
+    {
+        std::vector<SceneRecord>   records{};
+        std::vector<std::uint32_t> roots{};
+
+        for (const SceneRoots &scene : asset.scenes) {
+            const auto rootCount = scene.rootNodeIndices.size();
+
+            records.push_back(
+                SceneRecord{
+                    .firstRoot = static_cast<std::uint32_t>(roots.size()),
+                    .rootCount = static_cast<std::uint32_t>(rootCount),
+                });
+
+            roots.insert(
+                roots.end(),
+                scene.rootNodeIndices.begin(),
+                scene.rootNodeIndices.end());
+        }
+
+        writer.addSection(SectionId::kScenes, std::span{records});
+        writer.addSection(SectionId::kSceneRoots, std::span{roots});
+    }
+
+    {
+        std::vector<NodeRecord>    records{};
+        std::vector<std::uint32_t> children{};
+
+        for (const SceneNode &node : asset.nodes) {
+            records.push_back(
+                NodeRecord{
+                    .translation = node.translation,
+                    .rotation    = node.rotation,
+                    .scale       = node.scale,
+                    .meshIndex   = node.meshIndex.value_or(kNoIndex),
+                    .cameraIndex = node.cameraIndex.value_or(kNoIndex),
+                    .firstChild  = static_cast<std::uint32_t>(children.size()),
+                    .childCount =
+                        static_cast<std::uint32_t>(node.childNodeIndices.size()),
+                });
+
+            children.insert(
+                children.end(),
+                node.childNodeIndices.begin(),
+                node.childNodeIndices.end());
+        }
+
+        writer.addSection(SectionId::kNodes, std::span{records});
+        writer.addSection(SectionId::kNodeChildren, std::span{children});
+    }
+
+    {
+        std::vector<MeshRecord>    meshRecords{};
+        std::vector<SubmeshRecord> submeshRecords{};
+        std::vector<MeshVertex>    vertices{};
+        std::vector<std::byte>     indices{};
+        std::vector<std::uint16_t> narrowedIndices{};
+
+        for (const Mesh &mesh : asset.meshes) {
+            meshRecords.push_back(
+                MeshRecord{
+                    .firstSubmesh = static_cast<std::uint32_t>(submeshRecords.size()),
+                    .submeshCount = static_cast<std::uint32_t>(mesh.submeshes.size()),
+                });
+
+            for (const Submesh &submesh : mesh.submeshes) {
+                const auto submeshVertices = submesh.vertexData();
+                const auto submeshIndices  = gpuIndexBytes(submesh, narrowedIndices);
+
+                // keep every submesh's indices 4-byte aligned
+                indices.resize(static_cast<std::size_t>(
+                    alignUp(indices.size(), sizeof(std::uint32_t))));
+
+                submeshRecords.push_back(
+                    SubmeshRecord{
+                        .firstVertex    = vertices.size(),
+                        .firstIndexByte = indices.size(),
+                        .vertexCount    = static_cast<std::uint32_t>(submeshVertices.size()),
+                        .indexCount     = static_cast<std::uint32_t>(submesh.indexCount()),
+                        .materialIndex  = submesh.materialIndex,
+                        .topology       = static_cast<std::uint32_t>(submesh.topology),
+                        .tangentsValid  = submesh.tangentsValid ? 1u : 0u,
+                        .maxIndex = maxIndex(submeshIndices, submeshIndexType(submesh)),
+                        .uvEncoding = submesh.uvEncoding,
+                    });
+
+                vertices.insert(
+                    vertices.end(),
+                    submeshVertices.begin(),
+                    submeshVertices.end());
+
+                indices.insert(
+                    indices.end(),
+                    submeshIndices.begin(),
+                    submeshIndices.end());
+            }
+        }
+
+        writer.addSection(SectionId::kMeshes, std::span{meshRecords});
+        writer.addSection(SectionId::kSubmeshes, std::span{submeshRecords});
+        writer.addSection(SectionId::kVertices, std::span{vertices});
+        writer.addSection(SectionId::kIndices, std::span{indices});
+    }
+
+    writer.addSection(SectionId::kMaterials, std::span{asset.materials});
+
+    {
+        std::vector<TextureRecord> records{};
+        records.reserve(asset.textures.size());
+
+        for (const Texture &texture : asset.textures) {
+            TextureRecord record{};
+            record.imageIndex        = texture.imageIndex;
+            record.samplerInfo       = texture.samplerInfo;
+            record.samplerInfo.pNext = nullptr;
+
+            records.push_back(record);
+        }
+
+        writer.addSection(SectionId::kTextures, std::span{records});
+    }
+
+    {
+        std::vector<ImageRecord> records{};
+        std::vector<std::byte>   payload{};
+
+        for (const TextureImage &image : asset.images) {
+            const std::uint64_t offset = alignUp(payload.size(), kSectionAlignment);
+
+            records.push_back(
+                ImageRecord{
+                    .width         = image.extent.width,
+                    .height        = image.extent.height,
+                    .mipLevels     = image.mipLevels,
+                    .format        = static_cast<std::uint32_t>(image.format),
+                    .payloadOffset = offset,
+                    .payloadSize   = image.bytes().size(),
+                });
+
+            payload.resize(static_cast<std::size_t>(offset));
+            payload.insert(payload.end(), image.bytes().begin(), image.bytes().end());
+        }
+
+        writer.addSection(SectionId::kImages, std::span{records});
+        writer.addSection(SectionId::kImagePayload, std::span{payload});
+    }
+
+    {
+        const auto visitor = overloads{
+            [](const PerspectiveCamera &p) -> CameraRecord {
+                CameraRecord record{};
+                record.kind        = CameraKind::kPerspective;
+                record.yfov        = p.yfov;
+                record.aspectRatio = p.aspectRatio.value_or(0.0f);
+                record.znear       = p.znear;
+                record.zfar        = p.zfar.value_or(0.0f);
+
+                if (p.aspectRatio.has_value()) {
+                    record.flags |= kCameraHasAspectRatio;
+                }
+
+                if (p.zfar.has_value()) {
+                    record.flags |= kCameraHasZfar;
+                }
+
+                return record;
+            },
+            [](const OrthographicCamera &o) -> CameraRecord {
+                CameraRecord record{};
+                record.kind  = CameraKind::kOrthographic;
+                record.xmag  = o.xmag;
+                record.ymag  = o.ymag;
+                record.znear = o.znear;
+                record.zfar  = o.zfar;
+
+                return record;
+            },
+        };
+
+        std::vector<CameraRecord> records{};
+        records.reserve(asset.cameras.size());
+
+        for (const Camera &camera : asset.cameras) {
+            records.push_back(std::visit(visitor, camera.model));
+        }
+
+        writer.addSection(SectionId::kCameras, std::span{records});
+    }
+
+    if (cookedPath.has_parent_path()) {
+        std::filesystem::create_directories(cookedPath.parent_path());
+    }
+
+    writer.write(cookedPath, *sourceStamp);
+}
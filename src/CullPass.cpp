@@ -0,0 +1,367 @@
+#include "CullPass.hpp"
+
+#include "RenderableResources.hpp"
+#include "Shader.hpp"
+#include "ShaderInterfaceTypes.hpp"
+
+#include <array>
+
+static_assert(sizeof(IndirectDrawCommand) == sizeof(vk::DrawIndexedIndirectCommand));
+
+namespace
+{
+
+[[nodiscard]]
+auto makeCullInterfaceDescription() -> ShaderInterfaceDescription
+{
+    const auto compute = vk::ShaderStageFlags{vk::ShaderStageFlagBits::eCompute};
+
+    return ShaderInterfaceDescription{{
+        {kCullBindingFrameUniforms, vk::DescriptorType::eUniformBuffer, 1, compute},
+        {kCullBindingNodeInstanceData, vk::DescriptorType::eStorageBuffer, 1, compute},
+        {kCullBindingDrawBounds, vk::DescriptorType::eStorageBuffer, 1, compute},
+        {kCullBindingSourceCommands, vk::DescriptorType::eStorageBuffer, 1, compute},
+        {kCullBindingVisibleCommands, vk::DescriptorType::eStorageBuffer, 1, compute},
+        {kCullBindingVisibleCount, vk::DescriptorType::eStorageBuffer, 1, compute},
+        {kCullBindingDrawVisibility, vk::DescriptorType::eStorageBuffer, 1, compute},
+        {kCullBindingDepthPyramid, vk::DescriptorType::eSampledImage, 1, compute},
+    }};
+}
+
+} // namespace
+
+CullPass::CullPass(
+    Device                      &device,
+    const PipelineCache         &pipelineCache,
+    const std::filesystem::path &shaderPath,
+    uint32_t                     maxFramesInFlight,
+    bool                         occlusionCulling)
+    : shaderInterface{
+          device,
+          makeCullInterfaceDescription()},
+      descriptorPool{createDescriptorPool(
+          device,
+          maxFramesInFlight)},
+      pipelineLayout{createPipelineLayout(
+          device,
+          *shaderInterface.handle)},
+      frustumPipeline{createPipeline(
+          device,
+          pipelineCache,
+          shaderPath,
+          "cullMain",
+          pipelineLayout)}
+{
+    if (occlusionCulling) {
+        earlyPipeline = createPipeline(
+            device,
+            pipelineCache,
+            shaderPath,
+            "cullEarlyMain",
+            pipelineLayout);
+        latePipeline = createPipeline(
+            device,
+            pipelineCache,
+            shaderPath,
+            "cullLateMain",
+            pipelineLayout);
+    }
+
+    const auto layouts = std::vector<vk::DescriptorSetLayout>(
+        kListCount * maxFramesInFlight,
+        *shaderInterface.handle);
+
+    auto sets = device.handle.allocateDescriptorSets(
+        vk::DescriptorSetAllocateInfo{*descriptorPool, layouts});
+
+    for (auto &set : sets) {
+        descriptorSets.emplace_back(std::move(set));
+    }
+}
+
+auto CullPass::createDescriptorPool(
+    Device  &device,
+    uint32_t maxFramesInFlight) -> vk::raii::DescriptorPool
+{
+    const uint32_t maxSets = kListCount * maxFramesInFlight;
+
+    const auto poolSizes = std::array{
+        vk::DescriptorPoolSize{vk::DescriptorType::eUniformBuffer, maxSets},
+        vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer, 6u * maxSets},
+        vk::DescriptorPoolSize{vk::DescriptorType::eSampledImage, maxSets},
+    };
+
+    return vk::raii::DescriptorPool{
+        device.handle,
+        vk::DescriptorPoolCreateInfo{
+            vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+            maxSets,
+            poolSizes}};
+}
+
+auto CullPass::createPipelineLayout(
+    Device                       &device,
+    const vk::DescriptorSetLayout setLayout) -> vk::raii::PipelineLayout
+{
+    const auto pushConstants = std::array{vk::PushConstantRange{
+        vk::ShaderStageFlagBits::eCompute,
+        0,
+        sizeof(CullPushConstants)}};
+
+    return {device.handle, vk::PipelineLayoutCreateInfo{{}, setLayout, pushConstants}};
+}
+
+auto CullPass::createPipeline(
+    Device                         &device,
+    const PipelineCache            &pipelineCache,
+    const std::filesystem::path    &shaderPath,
+    const char                     *entryPoint,
+    const vk::raii::PipelineLayout &pipelineLayout) -> vk::raii::Pipeline
+{
+    auto shaderModule = createShaderModule(device.handle, shaderPath);
+
+    const auto computePipelineCreateInfo = vk::ComputePipelineCreateInfo{
+        {},
+        vk::PipelineShaderStageCreateInfo{
+            {},
+            vk::ShaderStageFlagBits::eCompute,
+            shaderModule,
+            entryPoint,
+            {},
+        },
+        *pipelineLayout,
+    };
+
+    return vk::raii::Pipeline{
+        device.handle,
+        pipelineCache.handle,
+        computePipelineCreateInfo};
+}
+
+auto CullPass::listIndex(
+    uint32_t frameIndex,
+    CullList list) -> std::size_t
+{
+    return static_cast<std::size_t>(frameIndex) * kListCount
+         + static_cast<std::size_t>(list);
+}
+
+auto CullPass::initializePerFrameBuffers(
+    Allocator &allocator,
+    uint32_t   drawCount) -> void
+{
+    visibleCommandsBuffers.clear();
+    visibleCountBuffers.clear();
+
+    describedSources.assign(descriptorSets.size() / kListCount, DescriptorSources{});
+
+    const uint32_t elemCount = (drawCount == 0u) ? 1u : drawCount;
+
+    const auto commandBytes =
+        static_cast<vk::DeviceSize>(sizeof(vk::DrawIndexedIndirectCommand))
+        * static_cast<vk::DeviceSize>(elemCount);
+
+    for (std::size_t i = 0u; i < descriptorSets.size(); ++i) {
+        visibleCommandsBuffers.emplace_back(allocator.createBuffer(
+            commandBytes,
+            vk::BufferUsageFlagBits2::eStorageBuffer
+                | vk::BufferUsageFlagBits2::eIndirectBuffer,
+            false,
+            VMA_MEMORY_USAGE_GPU_ONLY));
+
+        // one count per raster state group, at the group's first draw
+        visibleCountBuffers.emplace_back(allocator.createBuffer(
+            sizeof(uint32_t) * static_cast<vk::DeviceSize>(elemCount),
+            vk::BufferUsageFlagBits2::eStorageBuffer
+                | vk::BufferUsageFlagBits2::eIndirectBuffer
+                | vk::BufferUsageFlagBits2::eTransferDst,
+            false,
+            VMA_MEMORY_USAGE_GPU_ONLY));
+    }
+
+    drawVisibilityBuffer = allocator.createBuffer(
+        sizeof(uint32_t) * static_cast<vk::DeviceSize>(elemCount),
+        vk::BufferUsageFlagBits2::eStorageBuffer
+            | vk::BufferUsageFlagBits2::eTransferDst,
+        false,
+        VMA_MEMORY_USAGE_GPU_ONLY);
+
+    drawVisibilityCleared = false;
+}
+
+auto CullPass::updateDescriptorSet(
+    Device                    &device,
+    uint32_t                   frameIndex,
+    const Buffer              &frameUBO,
+    const Buffer              &nodeInstancesSSBO,
+    const RenderableResources &renderableResources,
+    vk::ImageView              depthPyramid,
+    const DescriptorSources   &sources) -> void
+{
+    auto &described = describedSources[frameIndex];
+
+    if (described == sources) {
+        return;
+    }
+
+    const auto wholeBuffer = [](const Buffer &buffer) {
+        return vk::DescriptorBufferInfo{buffer.buffer, 0, vk::WholeSize};
+    };
+
+    const auto bindings = std::array{
+        kCullBindingFrameUniforms,
+        kCullBindingNodeInstanceData,
+        kCullBindingDrawBounds,
+        kCullBindingSourceCommands,
+        kCullBindingVisibleCommands,
+        kCullBindingVisibleCount,
+        kCullBindingDrawVisibility,
+    };
+
+    const auto pyramidInfo = vk::DescriptorImageInfo{
+        {},
+        depthPyramid,
+        vk::ImageLayout::eGeneral,
+    };
+
+    auto bufferInfos = std::vector<vk::DescriptorBufferInfo>{};
+    bufferInfos.reserve(kListCount * bindings.size());
+
+    auto descriptorWrites = std::vector<vk::WriteDescriptorSet>{};
+    descriptorWrites.reserve(kListCount * (bindings.size() + 1u));
+
+    for (const auto list : {CullList::Main, CullList::Late}) {
+        const auto index = listIndex(frameIndex, list);
+
+        const vk::DescriptorSet descriptorSet = *descriptorSets[index];
+
+        const auto listBufferInfos = std::array{
+            vk::DescriptorBufferInfo{frameUBO.buffer, 0, sizeof(FrameUniforms)},
+            wholeBuffer(nodeInstancesSSBO),
+            wholeBuffer(renderableResources.drawBoundsSSBO),
+            wholeBuffer(renderableResources.indirectCommandsBuffer),
+            wholeBuffer(visibleCommandsBuffers[index]),
+            wholeBuffer(visibleCountBuffers[index]),
+            wholeBuffer(drawVisibilityBuffer),
+        };
+
+        for (std::size_t i = 0u; i < bindings.size(); ++i) {
+            const auto &bufferInfo = bufferInfos.emplace_back(listBufferInfos[i]);
+
+            descriptorWrites.emplace_back(
+                vk::WriteDescriptorSet{
+                    descriptorSet,
+                    bindings[i],
+                    0,
+                    bindings[i] == kCullBindingFrameUniforms
+                        ? vk::DescriptorType::eUniformBuffer
+                        : vk::DescriptorType::eStorageBuffer,
+                    {},
+                    bufferInfo,
+                });
+        }
+
+        if (depthPyramid) {
+            descriptorWrites.emplace_back(
+                vk::WriteDescriptorSet{
+                    descriptorSet,
+                    kCullBindingDepthPyramid,
+                    0,
+                    vk::DescriptorType::eSampledImage,
+                    pyramidInfo,
+                });
+        }
+    }
+
+    device.handle.updateDescriptorSets(descriptorWrites, {});
+
+    described = sources;
+}
+
+auto CullPass::record(
+    vk::raii::CommandBuffer  &cmd,
+    uint32_t                  frameIndex,
+    uint32_t                  drawCount,
+    CullPhase                 phase,
+    const DepthPyramidTarget &pyramid) -> void
+{
+    const CullList list = (phase == CullPhase::Late) ? CullList::Late : CullList::Main;
+    const auto     index = listIndex(frameIndex, list);
+
+    const vk::Buffer countBuffer = visibleCountBuffers[index].buffer;
+
+    cmd.fillBuffer(countBuffer, 0, vk::WholeSize, 0u);
+
+    // nothing was drawn before the first frame: the early phase draws
+    // nothing and the late phase tests everything
+    if (phase != CullPhase::Frustum && !drawVisibilityCleared) {
+        cmd.fillBuffer(drawVisibilityBuffer.buffer, 0, vk::WholeSize, 0u);
+        drawVisibilityCleared = true;
+    }
+
+    // count/visibility reset and the previous frame's visibility writes ->
+    // this dispatch
+    const auto clearToCullBarrier = vk::MemoryBarrier2{
+        vk::PipelineStageFlagBits2::eClear | vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eShaderStorageWrite,
+        vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eShaderStorageRead
+            | vk::AccessFlagBits2::eShaderStorageWrite,
+    };
+
+    cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(clearToCullBarrier));
+
+    const vk::Pipeline pipeline = (phase == CullPhase::Early) ? *earlyPipeline
+                                : (phase == CullPhase::Late)  ? *latePipeline
+                                                              : *frustumPipeline;
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+
+    cmd.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute,
+        *pipelineLayout,
+        0,
+        *descriptorSets[index],
+        {});
+
+    const auto pushConstant = CullPushConstants{
+        .drawCount         = drawCount,
+        .pyramidWidth      = pyramid.extent.width,
+        .pyramidHeight     = pyramid.extent.height,
+        .pyramidLevelCount = pyramid.levelCount,
+    };
+
+    cmd.pushConstants2(
+        vk::PushConstantsInfo{
+            *pipelineLayout,
+            vk::ShaderStageFlagBits::eCompute,
+            0,
+            sizeof(CullPushConstants),
+            &pushConstant});
+
+    cmd.dispatch((drawCount + kCullWorkgroupSize - 1u) / kCullWorkgroupSize, 1u, 1u);
+
+    // compacted commands + count -> indirect draw
+    const auto cullToDrawBarrier = vk::MemoryBarrier2{
+        vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eShaderStorageWrite,
+        vk::PipelineStageFlagBits2::eDrawIndirect,
+        vk::AccessFlagBits2::eIndirectCommandRead,
+    };
+
+    cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(cullToDrawBarrier));
+}
+
+auto CullPass::visibleCommands(
+    uint32_t frameIndex,
+    CullList list) const -> const Buffer &
+{
+    return visibleCommandsBuffers[listIndex(frameIndex, list)];
+}
+
+auto CullPass::visibleCount(
+    uint32_t frameIndex,
+    CullList list) const -> const Buffer &
+{
+    return visibleCountBuffers[listIndex(frameIndex, list)];
+}
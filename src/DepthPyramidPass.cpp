@@ -0,0 +1,238 @@
+#include "DepthPyramidPass.hpp"
+
+#include "Shader.hpp"
+#include "ShaderInterfaceTypes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace
+{
+
+[[nodiscard]]
+auto makePyramidInterfaceDescription() -> ShaderInterfaceDescription
+{
+    const auto compute = vk::ShaderStageFlags{vk::ShaderStageFlagBits::eCompute};
+
+    return ShaderInterfaceDescription{{
+        {kPyramidBindingSource, vk::DescriptorType::eSampledImage, 1, compute},
+        {kPyramidBindingDestination, vk::DescriptorType::eStorageImage, 1, compute},
+    }};
+}
+
+[[nodiscard]]
+auto groupCount(uint32_t size) -> uint32_t
+{
+    return (size + kPyramidWorkgroupSize - 1u) / kPyramidWorkgroupSize;
+}
+
+} // namespace
+
+DepthPyramidPass::DepthPyramidPass(
+    Device                      &device,
+    const PipelineCache         &pipelineCache,
+    const std::filesystem::path &shaderPath)
+    : shaderInterface{
+          device,
+          makePyramidInterfaceDescription()},
+      descriptorPool{createDescriptorPool(device)},
+      pipelineLayout{createPipelineLayout(
+          device,
+          *shaderInterface.handle)},
+      pipeline{createPipeline(
+          device,
+          pipelineCache,
+          shaderPath,
+          pipelineLayout)}
+{
+    const auto layouts =
+        std::vector<vk::DescriptorSetLayout>(kMaxLevels, *shaderInterface.handle);
+
+    auto sets = device.handle.allocateDescriptorSets(
+        vk::DescriptorSetAllocateInfo{*descriptorPool, layouts});
+
+    for (auto &set : sets) {
+        descriptorSets.emplace_back(std::move(set));
+    }
+}
+
+auto DepthPyramidPass::createDescriptorPool(Device &device) -> vk::raii::DescriptorPool
+{
+    const auto poolSizes = std::array{
+        vk::DescriptorPoolSize{vk::DescriptorType::eSampledImage, kMaxLevels},
+        vk::DescriptorPoolSize{vk::DescriptorType::eStorageImage, kMaxLevels},
+    };
+
+    return vk::raii::DescriptorPool{
+        device.handle,
+        vk::DescriptorPoolCreateInfo{
+            vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+            kMaxLevels,
+            poolSizes}};
+}
+
+auto DepthPyramidPass::createPipelineLayout(
+    Device                       &device,
+    const vk::DescriptorSetLayout setLayout) -> vk::raii::PipelineLayout
+{
+    const auto pushConstants = std::array{vk::PushConstantRange{
+        vk::ShaderStageFlagBits::eCompute,
+        0,
+        sizeof(DepthPyramidPushConstants)}};
+
+    return {device.handle, vk::PipelineLayoutCreateInfo{{}, setLayout, pushConstants}};
+}
+
+auto DepthPyramidPass::createPipeline(
+    Device                         &device,
+    const PipelineCache            &pipelineCache,
+    const std::filesystem::path    &shaderPath,
+    const vk::raii::PipelineLayout &pipelineLayout) -> vk::raii::Pipeline
+{
+    auto shaderModule = createShaderModule(device.handle, shaderPath);
+
+    const auto computePipelineCreateInfo = vk::ComputePipelineCreateInfo{
+        {},
+        vk::PipelineShaderStageCreateInfo{
+            {},
+            vk::ShaderStageFlagBits::eCompute,
+            shaderModule,
+            "reduceMain",
+            {},
+        },
+        *pipelineLayout,
+    };
+
+    return vk::raii::Pipeline{
+        device.handle,
+        pipelineCache.handle,
+        computePipelineCreateInfo};
+}
+
+auto DepthPyramidPass::updateDescriptorSets(
+    Device                   &device,
+    const DepthTarget        &depth,
+    const DepthPyramidTarget &pyramid,
+    uint64_t                  renderTargetsGeneration) -> void
+{
+    if (renderTargetsGeneration == describedGeneration) {
+        return;
+    }
+
+    if (pyramid.levelCount > kMaxLevels) {
+        throw std::runtime_error("DepthPyramidPass: too many pyramid levels");
+    }
+
+    auto imageInfos = std::vector<vk::DescriptorImageInfo>{};
+    imageInfos.reserve(2u * pyramid.levelCount);
+
+    auto descriptorWrites = std::vector<vk::WriteDescriptorSet>{};
+    descriptorWrites.reserve(2u * pyramid.levelCount);
+
+    for (uint32_t level = 0u; level < pyramid.levelCount; ++level) {
+        const vk::DescriptorSet descriptorSet = *descriptorSets[level];
+
+        const vk::ImageView sourceView =
+            (level == 0u) ? *depth.sampledView : *pyramid.levelViews[level - 1u];
+
+        const vk::ImageLayout sourceLayout = (level == 0u)
+                                               ? vk::ImageLayout::eShaderReadOnlyOptimal
+                                               : vk::ImageLayout::eGeneral;
+
+        const auto &sourceInfo = imageInfos.emplace_back(
+            vk::DescriptorImageInfo{{}, sourceView, sourceLayout});
+
+        descriptorWrites.emplace_back(
+            vk::WriteDescriptorSet{
+                descriptorSet,
+                kPyramidBindingSource,
+                0,
+                vk::DescriptorType::eSampledImage,
+                sourceInfo,
+            });
+
+        const auto &destinationInfo = imageInfos.emplace_back(
+            vk::DescriptorImageInfo{
+                {},
+                *pyramid.levelViews[level],
+                vk::ImageLayout::eGeneral});
+
+        descriptorWrites.emplace_back(
+            vk::WriteDescriptorSet{
+                descriptorSet,
+                kPyramidBindingDestination,
+                0,
+                vk::DescriptorType::eStorageImage,
+                destinationInfo,
+            });
+    }
+
+    device.handle.updateDescriptorSets(descriptorWrites, {});
+
+    describedGeneration = renderTargetsGeneration;
+}
+
+auto DepthPyramidPass::record(
+    vk::raii::CommandBuffer  &cmd,
+    const DepthTarget        &depth,
+    const DepthPyramidTarget &pyramid) const -> void
+{
+    // previous frame's occlusion reads -> level writes (same layout, so the
+    // layout tracker emits no barrier for this)
+    const auto readToWriteBarrier = vk::MemoryBarrier2{
+        vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eShaderSampledRead,
+        vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eShaderStorageWrite,
+    };
+
+    cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(readToWriteBarrier));
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+
+    // level N -> level N+1 and, after the last level, the occlusion test
+    const auto levelBarrier = vk::MemoryBarrier2{
+        vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eShaderStorageWrite,
+        vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eShaderSampledRead,
+    };
+
+    uint32_t sourceWidth  = depth.extent.width;
+    uint32_t sourceHeight = depth.extent.height;
+
+    for (uint32_t level = 0u; level < pyramid.levelCount; ++level) {
+        const uint32_t width  = std::max(pyramid.extent.width >> level, 1u);
+        const uint32_t height = std::max(pyramid.extent.height >> level, 1u);
+
+        cmd.bindDescriptorSets(
+            vk::PipelineBindPoint::eCompute,
+            *pipelineLayout,
+            0,
+            *descriptorSets[level],
+            {});
+
+        const auto pushConstant = DepthPyramidPushConstants{
+            .sourceWidth       = sourceWidth,
+            .sourceHeight      = sourceHeight,
+            .destinationWidth  = width,
+            .destinationHeight = height,
+        };
+
+        cmd.pushConstants2(
+            vk::PushConstantsInfo{
+                *pipelineLayout,
+                vk::ShaderStageFlagBits::eCompute,
+                0,
+                sizeof(DepthPyramidPushConstants),
+                &pushConstant});
+
+        cmd.dispatch(groupCount(width), groupCount(height), 1u);
+
+        cmd.pipelineBarrier2(vk::DependencyInfo{}.setMemoryBarriers(levelBarrier));
+
+        sourceWidth  = width;
+        sourceHeight = height;
+    }
+}
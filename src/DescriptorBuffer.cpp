@@ -0,0 +1,207 @@
+#include "DescriptorBuffer.hpp"
+
+#include "Utility.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+
+[[nodiscard]]
+auto alignUp(
+    vk::DeviceSize value,
+    vk::DeviceSize alignment) -> vk::DeviceSize
+{
+    return (value + alignment - 1u) / alignment * alignment;
+}
+
+} // namespace
+
+DescriptorBuffer::DescriptorBuffer(
+    const PhysicalDevice                &physicalDevice,
+    Device                              &device_,
+    Allocator                           &allocator_,
+    const vk::raii::DescriptorSetLayout &layout,
+    const ShaderInterfaceDescription    &description,
+    uint32_t                             maxFramesInFlight)
+    : device{device_},
+      properties{
+          physicalDevice.handle
+              .getProperties2<
+                  vk::PhysicalDeviceProperties2,
+                  vk::PhysicalDeviceDescriptorBufferPropertiesEXT>()
+              .get<vk::PhysicalDeviceDescriptorBufferPropertiesEXT>()},
+      allocator{allocator_.handle()}
+{
+    slotStride =
+        alignUp(layout.getSizeEXT(), properties.descriptorBufferOffsetAlignment);
+
+    for (const auto &binding : description.bindings) {
+        if (binding.binding >= bindingOffsets.size()) {
+            bindingOffsets.resize(binding.binding + 1u, 0u);
+        }
+
+        bindingOffsets[binding.binding] = layout.getBindingOffsetEXT(binding.binding);
+    }
+
+    // sampler and resource descriptors share the layout, so one buffer
+    // carries both usages
+    buffer = allocator_.createBuffer(
+        std::max<vk::DeviceSize>(slotStride * maxFramesInFlight, 1u),
+        vk::BufferUsageFlagBits2::eResourceDescriptorBufferEXT
+            | vk::BufferUsageFlagBits2::eSamplerDescriptorBufferEXT,
+        false,
+        VMA_MEMORY_USAGE_AUTO,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+            | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+    VmaAllocationInfo allocationInfo{};
+    vmaGetAllocationInfo(allocator, buffer.allocation, &allocationInfo);
+
+    mapped = static_cast<std::byte *>(allocationInfo.pMappedData);
+
+    if (mapped == nullptr) {
+        throw std::runtime_error("DescriptorBuffer: buffer is not host mapped");
+    }
+
+    address = device.handle.getBufferAddress(vk::BufferDeviceAddressInfo{buffer.buffer});
+}
+
+auto DescriptorBuffer::supported(
+    const PhysicalDevice &physicalDevice,
+    const Device         &device) -> bool
+{
+    if (!device.hasExtension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+        return false;
+    }
+
+    const auto featureChain = physicalDevice.handle.getFeatures2<
+        vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDeviceDescriptorBufferFeaturesEXT>();
+
+    return featureChain.get<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>()
+        .descriptorBuffer;
+}
+
+auto DescriptorBuffer::descriptorSize(vk::DescriptorType type) const -> std::size_t
+{
+    switch (type) {
+    case vk::DescriptorType::eUniformBuffer:
+        return properties.uniformBufferDescriptorSize;
+    case vk::DescriptorType::eStorageBuffer:
+        return properties.storageBufferDescriptorSize;
+    case vk::DescriptorType::eSampledImage:
+        return properties.sampledImageDescriptorSize;
+    case vk::DescriptorType::eSampler:
+        return properties.samplerDescriptorSize;
+    default:
+        throw std::runtime_error("DescriptorBuffer: unsupported descriptor type");
+    }
+}
+
+auto DescriptorBuffer::descriptorAddress(
+    uint32_t    frameIndex,
+    uint32_t    binding,
+    uint32_t    arrayElement,
+    std::size_t size) const -> std::byte *
+{
+    return mapped + slotStride * frameIndex + bindingOffsets[binding]
+         + static_cast<vk::DeviceSize>(arrayElement) * size;
+}
+
+auto DescriptorBuffer::writeBuffer(
+    uint32_t           frameIndex,
+    uint32_t           binding,
+    vk::DescriptorType type,
+    vk::Buffer         target,
+    vk::DeviceSize     range) -> void
+{
+    const auto addressInfo = vk::DescriptorAddressInfoEXT{
+        device.handle.getBufferAddress(vk::BufferDeviceAddressInfo{target}),
+        range,
+    };
+
+    auto data = vk::DescriptorDataEXT{};
+
+    if (type == vk::DescriptorType::eUniformBuffer) {
+        data.setPUniformBuffer(&addressInfo);
+    } else {
+        data.setPStorageBuffer(&addressInfo);
+    }
+
+    const std::size_t size = descriptorSize(type);
+
+    device.handle.getDescriptorEXT(
+        vk::DescriptorGetInfoEXT{type, data},
+        size,
+        descriptorAddress(frameIndex, binding, 0u, size));
+}
+
+auto DescriptorBuffer::writeSampledImages(
+    uint32_t                       frameIndex,
+    uint32_t                       binding,
+    std::span<const vk::ImageView> views) -> void
+{
+    const std::size_t size = descriptorSize(vk::DescriptorType::eSampledImage);
+
+    for (uint32_t element = 0u; element < views.size(); ++element) {
+        const auto imageInfo = vk::DescriptorImageInfo{
+            {},
+            views[element],
+            vk::ImageLayout::eShaderReadOnlyOptimal,
+        };
+
+        device.handle.getDescriptorEXT(
+            vk::DescriptorGetInfoEXT{
+                vk::DescriptorType::eSampledImage,
+                vk::DescriptorDataEXT{}.setPSampledImage(&imageInfo)},
+            size,
+            descriptorAddress(frameIndex, binding, element, size));
+    }
+}
+
+auto DescriptorBuffer::writeSamplers(
+    uint32_t                     frameIndex,
+    uint32_t                     binding,
+    std::span<const vk::Sampler> samplers) -> void
+{
+    const std::size_t size = descriptorSize(vk::DescriptorType::eSampler);
+
+    for (uint32_t element = 0u; element < samplers.size(); ++element) {
+        device.handle.getDescriptorEXT(
+            vk::DescriptorGetInfoEXT{
+                vk::DescriptorType::eSampler,
+                vk::DescriptorDataEXT{}.setPSampler(&samplers[element])},
+            size,
+            descriptorAddress(frameIndex, binding, element, size));
+    }
+}
+
+auto DescriptorBuffer::flush(uint32_t frameIndex) const -> void
+{
+    // the memory may be non-coherent (HOST_ACCESS_SEQUENTIAL_WRITE)
+    VK_CHECK(vmaFlushAllocation(
+        allocator,
+        buffer.allocation,
+        slotStride * frameIndex,
+        slotStride));
+}
+
+auto DescriptorBuffer::bind(
+    const vk::raii::CommandBuffer &cmd,
+    vk::PipelineBindPoint          bindPoint,
+    vk::PipelineLayout             layout,
+    uint32_t                       frameIndex) const -> void
+{
+    cmd.bindDescriptorBuffersEXT(
+        vk::DescriptorBufferBindingInfoEXT{
+            address,
+            vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT
+                | vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT});
+
+    const uint32_t       bufferIndex = 0u;
+    const vk::DeviceSize offset      = slotStride * frameIndex;
+
+    cmd.setDescriptorBufferOffsetsEXT(bindPoint, layout, 0u, bufferIndex, offset);
+}
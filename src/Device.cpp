@@ -1,5 +1,7 @@
 #include "Device.hpp"
 
+#include <algorithm>
+#include <ranges>
 #include <fmt/base.h>
 #include <set>
 #include <vector>
@@ -8,15 +10,21 @@ Device::Device(
     const PhysicalDevice            &physicalDevice,
     const Window                    &window,
     const Surface                   &surface,
-    const std::vector<const char *> &requiredExtensions)
-    : window{window},
+    const std::vector<const char *> &requiredExtensions,
+    const std::vector<const char *> &optionalExtensions)
+    : physicalDevice{physicalDevice},
+      window{window},
       queueFamilyIndices{findQueueFamilies(
           physicalDevice,
           surface)},
+      enabledExtensions{selectExtensions(
+          physicalDevice,
+          requiredExtensions,
+          optionalExtensions)},
       handle{createDevice(
           physicalDevice,
           queueFamilyIndices,
-          requiredExtensions)},
+          enabledExtensions)},
       graphicsQueue(
           handle,
           queueFamilyIndices.graphicsIndex,
@@ -24,14 +32,45 @@ Device::Device(
       presentQueue(
           handle,
           queueFamilyIndices.presentIndex,
+          0),
+      transferQueue(
+          handle,
+          queueFamilyIndices.transferIndex,
           0)
 {
 }
 
-auto Device::createDevice(
+auto Device::selectExtensions(
     const PhysicalDevice            &physicalDevice,
-    const QueueFamilyIndices        &queueFamilyIndices,
-    const std::vector<const char *> &requiredExtensions) -> vk::raii::Device
+    const std::vector<const char *> &requiredExtensions,
+    const std::vector<const char *> &optionalExtensions) -> std::vector<std::string>
+{
+    auto extensions =
+        std::vector<std::string>{requiredExtensions.begin(), requiredExtensions.end()};
+
+    const auto missingExtensions =
+        PhysicalDevice::getMissingExtensions(physicalDevice.handle, optionalExtensions);
+
+    for (const char *extension : optionalExtensions) {
+        if (std::ranges::contains(missingExtensions, extension)) {
+            fmt::println(stderr, "optional extension {} unsupported", extension);
+        } else {
+            extensions.emplace_back(extension);
+        }
+    }
+
+    return extensions;
+}
+
+auto Device::hasExtension(std::string_view extension) const -> bool
+{
+    return std::ranges::contains(enabledExtensions, extension);
+}
+
+auto Device::createDevice(
+    const PhysicalDevice           &physicalDevice,
+    const QueueFamilyIndices       &queueFamilyIndices,
+    const std::vector<std::string> &extensions) -> vk::raii::Device
 {
 
     auto features2 = physicalDevice.handle.getFeatures2<
@@ -52,12 +91,25 @@ auto Device::createDevice(
         vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT,
         vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>();
 
+    // features of extensions that are not enabled must not be chained
+    if (!std::ranges::contains(extensions, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+        features2.unlink<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>();
+    }
+
+    const auto extensionNames =
+        extensions
+        | std::views::transform([](const std::string &extension) -> const char * {
+              return extension.c_str();
+          })
+        | std::ranges::to<std::vector>();
+
     const float queuePriority = 1.0f;
 
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t>                     uniqueQueueFamilies = {
         queueFamilyIndices.graphicsIndex,
-        queueFamilyIndices.presentIndex};
+        queueFamilyIndices.presentIndex,
+        queueFamilyIndices.transferIndex};
 
     for (uint32_t familyIndex : uniqueQueueFamilies) {
         queueCreateInfos
@@ -68,7 +120,7 @@ auto Device::createDevice(
         {},
         queueCreateInfos,
         {},
-        requiredExtensions,
+        extensionNames,
         {},
         &features2.get<vk::PhysicalDeviceFeatures2>()};
 
@@ -117,5 +169,30 @@ auto Device::findQueueFamilies(
             "separate queues not implemented yet.");
     }
 
+    // Uploads prefer a transfer-only family (usually a DMA engine), then any
+    // non-graphics family that can transfer, then the graphics family.
+    const auto findTransferFamily = [&](vk::QueueFlags excluded) {
+        for (uint32_t index = 0; index < queueFamilyProperties.size(); ++index) {
+            const auto flags = queueFamilyProperties[index].queueFlags;
+
+            if ((flags & vk::QueueFlagBits::eTransfer) && !(flags & excluded)) {
+                return index;
+            }
+        }
+
+        return std::numeric_limits<uint32_t>::max();
+    };
+
+    queueFamilyIndices.transferIndex =
+        findTransferFamily(vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute);
+
+    if (queueFamilyIndices.transferIndex == std::numeric_limits<uint32_t>::max()) {
+        queueFamilyIndices.transferIndex = findTransferFamily(vk::QueueFlagBits::eGraphics);
+    }
+
+    if (queueFamilyIndices.transferIndex == std::numeric_limits<uint32_t>::max()) {
+        queueFamilyIndices.transferIndex = queueFamilyIndices.graphicsIndex;
+    }
+
     return queueFamilyIndices;
 }
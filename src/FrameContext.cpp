@@ -1,4 +1,5 @@
 #include "FrameContext.hpp"
+#include "DescriptorSources.hpp"
 #include "ShaderInterfaceTypes.hpp"
 
 #include <numeric>
@@ -104,6 +105,8 @@ auto FrameContext::initializePerFrameUniformBuffers(
     frameUBO.clear();
     nodeInstancesSSBO.clear();
 
+    uniformBuffersGeneration = nextDescriptorSourceGeneration();
+
     frameUBO.reserve(maxFramesInFlight);
     nodeInstancesSSBO.reserve(maxFramesInFlight);
 
@@ -134,3 +137,11 @@ auto FrameContext::initializePerFrameUniformBuffers(
                 | VMA_ALLOCATION_CREATE_MAPPED_BIT));
     }
 }
+
+auto FrameContext::initializeTransientRing(
+    Device        &device,
+    Allocator     &allocator,
+    vk::DeviceSize capacity) -> void
+{
+    transientRing.emplace(device, allocator, capacity);
+}
@@ -0,0 +1,378 @@
+#include "FrustumCulling.hpp"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#include <glm/geometric.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NIENNA_CULL_X86 1
+#include <immintrin.h>
+#else
+#define NIENNA_CULL_X86 0
+#endif
+
+// GCC/Clang can compile the AVX2 kernel alongside the baseline and pick it at
+// runtime; MSVC only gets it when the whole build targets AVX2.
+#if NIENNA_CULL_X86 && (defined(__GNUC__) || defined(__clang__))
+#define NIENNA_CULL_AVX2 1
+#define NIENNA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#elif NIENNA_CULL_X86 && defined(__AVX2__)
+#define NIENNA_CULL_AVX2 1
+#define NIENNA_TARGET_AVX2
+#else
+#define NIENNA_CULL_AVX2 0
+#endif
+
+namespace
+{
+
+// Extent of invalid and padding boxes: rejected by every real plane.
+constexpr float kEmptyExtent = -std::numeric_limits<float>::max();
+
+// Per-plane constants splatted once per cull call.
+struct PlaneTerms {
+    float nx, ny, nz, d;
+    float ax, ay, az;
+};
+
+auto makePlaneTerms(const Frustum &frustum) -> std::array<PlaneTerms, 6>
+{
+    std::array<PlaneTerms, 6> terms{};
+
+    for (std::size_t i = 0u; i < terms.size(); ++i) {
+        const glm::vec4 &plane = frustum.planes[i];
+
+        terms[i] = PlaneTerms{
+            .nx = plane.x,
+            .ny = plane.y,
+            .nz = plane.z,
+            .d  = plane.w,
+            .ax = std::abs(plane.x),
+            .ay = std::abs(plane.y),
+            .az = std::abs(plane.z),
+        };
+    }
+
+    return terms;
+}
+
+auto appendVisible(
+    std::uint32_t               mask,
+    std::size_t                 firstIndex,
+    std::size_t                 count,
+    std::vector<std::uint32_t> &visibleDrawIndices) -> void
+{
+    while (mask != 0u) {
+        const auto lane  = static_cast<std::size_t>(std::countr_zero(mask));
+        const auto index = firstIndex + lane;
+
+        // padding lanes past count are never reported
+        if (index < count) {
+            visibleDrawIndices.push_back(static_cast<std::uint32_t>(index));
+        }
+
+        mask &= mask - 1u;
+    }
+}
+
+// A box is outside a plane when even its most positive corner along the
+// plane normal is behind it: dot(n, c) + d + dot(|n|, e) < 0. The SIMD
+// kernels below evaluate the same expression per lane.
+#if !NIENNA_CULL_X86
+
+auto cullScalar(
+    const std::array<PlaneTerms, 6> &planes,
+    const float                     *cx,
+    const float                     *cy,
+    const float                     *cz,
+    const float                     *ex,
+    const float                     *ey,
+    const float                     *ez,
+    std::size_t                      count,
+    std::vector<std::uint32_t>      &visibleDrawIndices) -> void
+{
+    for (std::size_t i = 0u; i < count; ++i) {
+        bool visible = true;
+
+        for (const PlaneTerms &p : planes) {
+            const float distance = p.nx * cx[i] + p.ny * cy[i] + p.nz * cz[i] + p.d;
+            const float radius   = p.ax * ex[i] + p.ay * ey[i] + p.az * ez[i];
+
+            if (distance + radius < 0.0f) {
+                visible = false;
+                break;
+            }
+        }
+
+        if (visible) {
+            visibleDrawIndices.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+#endif
+
+#if NIENNA_CULL_X86
+
+auto cullSse2(
+    const std::array<PlaneTerms, 6> &planes,
+    const float                     *cx,
+    const float                     *cy,
+    const float                     *cz,
+    const float                     *ex,
+    const float                     *ey,
+    const float                     *ez,
+    std::size_t                      count,
+    std::vector<std::uint32_t>      &visibleDrawIndices) -> void
+{
+    const __m128 zero = _mm_setzero_ps();
+
+    for (std::size_t i = 0u; i < count; i += 4u) {
+        const __m128 centerX = _mm_loadu_ps(cx + i);
+        const __m128 centerY = _mm_loadu_ps(cy + i);
+        const __m128 centerZ = _mm_loadu_ps(cz + i);
+        const __m128 extentX = _mm_loadu_ps(ex + i);
+        const __m128 extentY = _mm_loadu_ps(ey + i);
+        const __m128 extentZ = _mm_loadu_ps(ez + i);
+
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (const PlaneTerms &p : planes) {
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(
+                    _mm_mul_ps(_mm_set1_ps(p.nx), centerX),
+                    _mm_mul_ps(_mm_set1_ps(p.ny), centerY)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.nz), centerZ), _mm_set1_ps(p.d)));
+
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(p.ax), extentX));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(p.ay), extentY));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(p.az), extentZ));
+
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, zero));
+        }
+
+        appendVisible(
+            static_cast<std::uint32_t>(_mm_movemask_ps(visible)),
+            i,
+            count,
+            visibleDrawIndices);
+    }
+}
+
+#endif
+
+#if NIENNA_CULL_AVX2
+
+NIENNA_TARGET_AVX2
+auto cullAvx2(
+    const std::array<PlaneTerms, 6> &planes,
+    const float                     *cx,
+    const float                     *cy,
+    const float                     *cz,
+    const float                     *ex,
+    const float                     *ey,
+    const float                     *ez,
+    std::size_t                      count,
+    std::vector<std::uint32_t>      &visibleDrawIndices) -> void
+{
+    const __m256 zero = _mm256_setzero_ps();
+
+    for (std::size_t i = 0u; i < count; i += 8u) {
+        const __m256 centerX = _mm256_loadu_ps(cx + i);
+        const __m256 centerY = _mm256_loadu_ps(cy + i);
+        const __m256 centerZ = _mm256_loadu_ps(cz + i);
+        const __m256 extentX = _mm256_loadu_ps(ex + i);
+        const __m256 extentY = _mm256_loadu_ps(ey + i);
+        const __m256 extentZ = _mm256_loadu_ps(ez + i);
+
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (const PlaneTerms &p : planes) {
+            __m256 distance = _mm256_fmadd_ps(
+                _mm256_set1_ps(p.nx),
+                centerX,
+                _mm256_set1_ps(p.d));
+
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(p.ny), centerY, distance);
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(p.nz), centerZ, distance);
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(p.ax), extentX, distance);
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(p.ay), extentY, distance);
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(p.az), extentZ, distance);
+
+            visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+        }
+
+        appendVisible(
+            static_cast<std::uint32_t>(_mm256_movemask_ps(visible)),
+            i,
+            count,
+            visibleDrawIndices);
+    }
+}
+
+[[nodiscard]]
+auto cpuHasAvx2() -> bool
+{
+#if defined(__GNUC__) || defined(__clang__)
+    static const bool hasAvx2 =
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+    return hasAvx2;
+#else
+    return true;
+#endif
+}
+
+#endif
+
+} // namespace
+
+auto Frustum::fromViewProjection(const glm::mat4 &viewProjection) -> Frustum
+{
+    // glm is column-major: row r of the matrix is (m[0][r], m[1][r], ...).
+    const auto row = [&](int r) {
+        return glm::vec4{
+            viewProjection[0][r],
+            viewProjection[1][r],
+            viewProjection[2][r],
+            viewProjection[3][r],
+        };
+    };
+
+    const glm::vec4 row0 = row(0);
+    const glm::vec4 row1 = row(1);
+    const glm::vec4 row2 = row(2);
+    const glm::vec4 row3 = row(3);
+
+    Frustum frustum{};
+
+    frustum.planes = {
+        row3 + row0, // left:   x >= -w
+        row3 - row0, // right:  x <= w
+        row3 + row1, // bottom: y >= -w
+        row3 - row1, // top:    y <= w
+        row2,        // near:   z >= 0
+        row3 - row2, // far:    z <= w
+    };
+
+    for (glm::vec4 &plane : frustum.planes) {
+        const float length = glm::length(glm::vec3{plane});
+
+        // an infinite far plane degenerates to (0, 0, 0, w); never cull by it
+        if (length > 0.0f) {
+            plane /= length;
+        } else {
+            plane = glm::vec4{0.0f, 0.0f, 0.0f, 1.0f};
+        }
+    }
+
+    return frustum;
+}
+
+auto DrawBoundsSoA::clear() -> void
+{
+    count = 0u;
+
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    extentX.clear();
+    extentY.clear();
+    extentZ.clear();
+}
+
+auto DrawBoundsSoA::reserve(std::size_t capacity) -> void
+{
+    const std::size_t padded = (capacity + kLaneCount - 1u) / kLaneCount * kLaneCount;
+
+    centerX.reserve(padded);
+    centerY.reserve(padded);
+    centerZ.reserve(padded);
+    extentX.reserve(padded);
+    extentY.reserve(padded);
+    extentZ.reserve(padded);
+}
+
+auto DrawBoundsSoA::push(const AABB &worldAABB) -> void
+{
+    // arrays always hold a whole number of lanes; grow by one group of
+    // padding boxes when full
+    if (count == centerX.size()) {
+        pad();
+    }
+
+    set(count, worldAABB);
+
+    ++count;
+}
+
+auto DrawBoundsSoA::set(
+    std::size_t index,
+    const AABB &worldAABB) -> void
+{
+    glm::vec3 center{0.0f};
+    glm::vec3 extent{kEmptyExtent};
+
+    if (worldAABB.isValid()) {
+        center = 0.5f * (worldAABB.min + worldAABB.max);
+        extent = 0.5f * (worldAABB.max - worldAABB.min);
+    }
+
+    centerX[index] = center.x;
+    centerY[index] = center.y;
+    centerZ[index] = center.z;
+    extentX[index] = extent.x;
+    extentY[index] = extent.y;
+    extentZ[index] = extent.z;
+}
+
+auto DrawBoundsSoA::pad() -> void
+{
+    const std::size_t padded = centerX.size() + kLaneCount;
+
+    centerX.resize(padded, 0.0f);
+    centerY.resize(padded, 0.0f);
+    centerZ.resize(padded, 0.0f);
+    extentX.resize(padded, kEmptyExtent);
+    extentY.resize(padded, kEmptyExtent);
+    extentZ.resize(padded, kEmptyExtent);
+}
+
+auto FrustumCuller::cull(
+    const Frustum              &frustum,
+    const DrawBoundsSoA        &bounds,
+    std::vector<std::uint32_t> &visibleDrawIndices) -> CullStats
+{
+    visibleDrawIndices.clear();
+    visibleDrawIndices.reserve(bounds.count);
+
+    const auto planes = makePlaneTerms(frustum);
+
+    const float *cx = bounds.centerX.data();
+    const float *cy = bounds.centerY.data();
+    const float *cz = bounds.centerZ.data();
+    const float *ex = bounds.extentX.data();
+    const float *ey = bounds.extentY.data();
+    const float *ez = bounds.extentZ.data();
+
+#if NIENNA_CULL_AVX2
+    if (cpuHasAvx2()) {
+        cullAvx2(planes, cx, cy, cz, ex, ey, ez, bounds.count, visibleDrawIndices);
+    } else {
+        cullSse2(planes, cx, cy, cz, ex, ey, ez, bounds.count, visibleDrawIndices);
+    }
+#elif NIENNA_CULL_X86
+    cullSse2(planes, cx, cy, cz, ex, ey, ez, bounds.count, visibleDrawIndices);
+#else
+    cullScalar(planes, cx, cy, cz, ex, ey, ez, bounds.count, visibleDrawIndices);
+#endif
+
+    const auto tested = static_cast<std::uint32_t>(bounds.count);
+
+    return CullStats{
+        .tested = tested,
+        .culled = tested - static_cast<std::uint32_t>(visibleDrawIndices.size()),
+    };
+}
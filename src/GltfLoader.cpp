@@ -1,18 +1,38 @@
 #include "GltfLoader.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <memory>
+#include <ranges>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <variant>
 #include <vector>
 
 #include <fastgltf/core.hpp>
 #include <fastgltf/glm_element_traits.hpp>
 #include <fastgltf/tools.hpp>
 
+#include <fmt/base.h>
 #include <stb_image.h>
 
+#include "BlockCompression.hpp"
+#include "CookedAsset.hpp"
+#include "Ktx2.hpp"
+#include "MappedFile.hpp"
+#include "MeshOptimization.hpp"
+#include "MipChain.hpp"
+#include "Parallel.hpp"
+#include "ShaderInterfaceTypes.hpp"
+#include "VertexPacking.hpp"
+
 namespace
 {
 
@@ -35,35 +55,193 @@ auto toGlm(const fastgltf::math::fquat &quat) -> glm::quat
     return {quat.w(), quat.x(), quat.y(), quat.z()};
 }
 
-auto parseGltfAsset(const std::filesystem::path &gltfPath) -> fastgltf::Asset
+// Parsed glTF plus the file mappings its ByteView sources point into. The
+// mappings must outlive every access to the asset's buffer data.
+struct ParsedGltf {
+#if FASTGLTF_HAS_MEMORY_MAPPED_FILE
+    std::unique_ptr<fastgltf::MappedGltfFile> mappedGltfFile;
+#endif
+    std::vector<MappedFile> mappedBuffers;
+
+    fastgltf::Asset asset;
+
+    // Every file the asset was built from, relative to its directory; the
+    // glTF/GLB itself comes first. Used to validate cooked snapshots.
+    std::vector<std::filesystem::path> sourceFiles;
+};
+
+// Record the external buffer and image files referenced by the asset. Must
+// run before external buffers are resolved, while they are still URIs.
+auto collectSourceFiles(
+    ParsedGltf                  &parsed,
+    const std::filesystem::path &gltfPath) -> void
+{
+    parsed.sourceFiles.push_back(gltfPath.filename());
+
+    const auto addUri = [&](const fastgltf::DataSource &data) {
+        const auto *uri = std::get_if<fastgltf::sources::URI>(&data);
+
+        if (uri != nullptr && uri->uri.isLocalPath()) {
+            parsed.sourceFiles.push_back(uri->uri.fspath());
+        }
+    };
+
+    for (const fastgltf::Buffer &buffer : parsed.asset.buffers) {
+        addUri(buffer.data);
+    }
+
+    for (const fastgltf::Image &image : parsed.asset.images) {
+        addUri(image.data);
+    }
+}
+
+// Replace each external (URI) buffer with a heap copy of its file contents.
+auto readExternalBuffers(
+    ParsedGltf                  &parsed,
+    const std::filesystem::path &directory) -> void
+{
+    for (fastgltf::Buffer &buffer : parsed.asset.buffers) {
+        const auto *uri = std::get_if<fastgltf::sources::URI>(&buffer.data);
+
+        if (uri == nullptr) {
+            continue;
+        }
+
+        if (!uri->uri.isLocalPath()) {
+            throw std::runtime_error("buffer URI unsupported");
+        }
+
+        std::ifstream file{directory / uri->uri.fspath(), std::ios::binary};
+
+        if (!file) {
+            throw std::runtime_error("buffer file unreadable");
+        }
+
+        fastgltf::sources::Vector vector{};
+        vector.mimeType = uri->mimeType;
+        vector.bytes.resize(buffer.byteLength);
+
+        file.seekg(static_cast<std::streamoff>(uri->fileByteOffset));
+        file.read(
+            reinterpret_cast<char *>(vector.bytes.data()),
+            static_cast<std::streamsize>(vector.bytes.size()));
+
+        if (!file) {
+            throw std::runtime_error("buffer file too small");
+        }
+
+        buffer.data = std::move(vector);
+    }
+}
+
+// Replace each external (URI) buffer with a ByteView into a mapping of its
+// file, which is what LoadExternalBuffers would otherwise copy to the heap.
+auto mapExternalBuffers(
+    ParsedGltf                  &parsed,
+    const std::filesystem::path &directory) -> void
+{
+    for (fastgltf::Buffer &buffer : parsed.asset.buffers) {
+        const auto *uri = std::get_if<fastgltf::sources::URI>(&buffer.data);
+
+        if (uri == nullptr) {
+            continue;
+        }
+
+        if (!uri->uri.isLocalPath()) {
+            throw std::runtime_error("buffer URI unsupported");
+        }
+
+        const MappedFile &mappedFile =
+            parsed.mappedBuffers.emplace_back(directory / uri->uri.fspath());
+
+        const auto bytes = mappedFile.bytes();
+
+        if (uri->fileByteOffset > bytes.size()
+            || bytes.size() - uri->fileByteOffset < buffer.byteLength) {
+            throw std::runtime_error("buffer file too small");
+        }
+
+        const auto mimeType = uri->mimeType;
+
+        buffer.data = fastgltf::sources::ByteView{
+            fastgltf::span<const std::byte>{
+                bytes.data() + uri->fileByteOffset,
+                buffer.byteLength,
+            },
+            mimeType,
+        };
+    }
+}
+
+auto parseGltfAsset(
+    const std::filesystem::path &gltfPath,
+    const AssetLoadOptions      &options) -> ParsedGltf
 {
     const auto supportedExtensions = fastgltf::Extensions::KHR_texture_transform
                                    | fastgltf::Extensions::KHR_materials_unlit
                                    | fastgltf::Extensions::KHR_lights_punctual
                                    | fastgltf::Extensions::KHR_materials_specular
                                    | fastgltf::Extensions::KHR_materials_ior
-                                   | fastgltf::Extensions::KHR_materials_clearcoat;
+                                   | fastgltf::Extensions::KHR_materials_clearcoat
+                                   | fastgltf::Extensions::KHR_texture_basisu
+                                   | fastgltf::Extensions::KHR_mesh_quantization;
 
     fastgltf::Parser parser{supportedExtensions};
 
-    constexpr auto gltfOptions = fastgltf::Options::DontRequireValidAssetMember
-                               | fastgltf::Options::LoadExternalBuffers
-                               | fastgltf::Options::DecomposeNodeMatrices
-                               | fastgltf::Options::GenerateMeshIndices;
+    constexpr auto commonOptions = fastgltf::Options::DontRequireValidAssetMember
+                                 | fastgltf::Options::DecomposeNodeMatrices
+                                 | fastgltf::Options::GenerateMeshIndices;
 
-    auto gltfFile = fastgltf::GltfDataBuffer::FromPath(gltfPath);
+    // External buffers stay URIs so their files can be recorded for cooked
+    // snapshot validation; they are mapped or read once parsing succeeds.
+    constexpr auto gltfOptions = commonOptions;
 
-    if (!bool(gltfFile)) {
-        throw std::runtime_error("parseGltfAsset failed");
-    }
+    ParsedGltf parsed{};
+
+    auto loaded = [&] {
+#if FASTGLTF_HAS_MEMORY_MAPPED_FILE
+        if (options.memoryMapped) {
+            // GLB binary chunks are exposed as ByteViews into this mapping.
+            auto mappedFile = fastgltf::MappedGltfFile::FromPath(gltfPath);
+
+            if (!bool(mappedFile)) {
+                throw std::runtime_error("parseGltfAsset failed");
+            }
+
+            parsed.mappedGltfFile =
+                std::make_unique<fastgltf::MappedGltfFile>(std::move(mappedFile.get()));
 
-    auto loaded = parser.loadGltf(gltfFile.get(), gltfPath.parent_path(), gltfOptions);
+            return parser.loadGltf(
+                *parsed.mappedGltfFile,
+                gltfPath.parent_path(),
+                gltfOptions);
+        }
+#endif
+
+        auto gltfFile = fastgltf::GltfDataBuffer::FromPath(gltfPath);
+
+        if (!bool(gltfFile)) {
+            throw std::runtime_error("parseGltfAsset failed");
+        }
+
+        return parser.loadGltf(gltfFile.get(), gltfPath.parent_path(), gltfOptions);
+    }();
 
     if (loaded.error() != fastgltf::Error::None) {
         throw std::runtime_error("parseGltfAsset failed");
     }
 
-    return std::move(loaded.get());
+    parsed.asset = std::move(loaded.get());
+
+    collectSourceFiles(parsed, gltfPath);
+
+    if (options.memoryMapped) {
+        mapExternalBuffers(parsed, gltfPath.parent_path());
+    } else {
+        readExternalBuffers(parsed, gltfPath.parent_path());
+    }
+
+    return parsed;
 }
 
 auto makePixel(
@@ -348,41 +526,97 @@ auto getBufferBytes(
     return buffer.data.visit(visitor);
 }
 
+auto toTextureImage(DecodedImage decoded) -> TextureImage
+{
+    TextureImage image{};
+    image.extent = decoded.extent;
+    image.data   = std::move(decoded.rgba8);
+
+    return image;
+}
+
+// KTX2 containers are read or transcoded for the device's formats;
+// everything else is decoded to RGBA8 by stb_image.
+auto decodeImageBytes(
+    std::span<const std::byte>  bytes,
+    const TextureFormatSupport &formats) -> TextureImage
+{
+    if (isKtx2(bytes)) {
+        return readKtx2(bytes, formats);
+    }
+
+    // stb_image takes the length as int
+    if (bytes.size() > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("image too large to decode");
+    }
+
+    const auto *data = reinterpret_cast<const unsigned char *>(bytes.data());
+
+    return toTextureImage(decodeImageFromMemory(data, static_cast<int>(bytes.size())));
+}
+
 auto decodeImage(
     const fastgltf::Asset       &gltfAsset,
     const fastgltf::Image       &image,
-    const std::filesystem::path &directory) -> DecodedImage
+    const std::filesystem::path &directory,
+    const AssetLoadOptions      &options) -> TextureImage
 {
     const auto visitor = overloads{
-        [&](const fastgltf::sources::URI &uri) -> DecodedImage {
+        [&](const fastgltf::sources::URI &uri) -> TextureImage {
             if (!uri.uri.isLocalPath()) {
                 throw std::runtime_error("image URI unsupported");
             }
 
+            const auto path = directory / uri.uri.fspath();
+
+            if (options.memoryMapped) {
+                // Decode straight from the page cache; the mapping only
+                // needs to live until the pixels have been produced.
+                const MappedFile mappedFile{path};
+
+                const auto bytes = mappedFile.bytes();
+
+                if (uri.fileByteOffset > bytes.size()) {
+                    throw std::runtime_error("image URI offset");
+                }
+
+                return decodeImageBytes(
+                    bytes.subspan(uri.fileByteOffset),
+                    options.textureFormats);
+            }
+
             if (uri.fileByteOffset != 0u) {
                 throw std::runtime_error("image URI offset");
             }
 
-            const auto path = directory / uri.uri.fspath();
-            return decodeImageFromFile(path);
-        },
-        [&](const fastgltf::sources::Vector &vector) -> DecodedImage {
-            const auto *data =
-                reinterpret_cast<const unsigned char *>(vector.bytes.data());
+            if (uri.mimeType == fastgltf::MimeType::KTX2
+                || path.extension() == ".ktx2") {
+                std::ifstream file{path, std::ios::binary};
 
-            const int size = static_cast<int>(vector.bytes.size());
+                if (!file) {
+                    throw std::runtime_error("image file unreadable");
+                }
 
-            return decodeImageFromMemory(data, size);
-        },
-        [&](const fastgltf::sources::ByteView &byteView) -> DecodedImage {
-            const auto *data =
-                reinterpret_cast<const unsigned char *>(byteView.bytes.data());
+                const std::vector<char> bytes{
+                    std::istreambuf_iterator<char>{file},
+                    std::istreambuf_iterator<char>{}};
 
-            const int size = static_cast<int>(byteView.bytes.size());
+                return readKtx2(std::as_bytes(std::span{bytes}), options.textureFormats);
+            }
 
-            return decodeImageFromMemory(data, size);
+            return toTextureImage(decodeImageFromFile(path));
+        },
+        [&](const fastgltf::sources::Vector &vector) -> TextureImage {
+            return decodeImageBytes(
+                std::span{vector.bytes.data(), vector.bytes.size()},
+                options.textureFormats);
         },
-        [&](const fastgltf::sources::BufferView &view) -> DecodedImage {
+        [&](const fastgltf::sources::ByteView &byteView) -> TextureImage {
+            return decodeImageBytes(
+                std::span{byteView.bytes.data(), byteView.bytes.size()},
+                options.textureFormats);
+        },
+        [&](const fastgltf::sources::BufferView &view) -> TextureImage {
             const fastgltf::BufferView &bufferView =
                 gltfAsset.bufferViews[view.bufferViewIndex];
 
@@ -392,14 +626,11 @@ auto decodeImage(
             const std::size_t offset = bufferView.byteOffset;
             const std::size_t length = bufferView.byteLength;
 
-            const auto *data =
-                reinterpret_cast<const unsigned char *>(bufferBytes.data + offset);
-
-            const int size = static_cast<int>(length);
-
-            return decodeImageFromMemory(data, size);
+            return decodeImageBytes(
+                std::span{bufferBytes.data + offset, length},
+                options.textureFormats);
         },
-        [&](const auto &) -> DecodedImage {
+        [&](const auto &) -> TextureImage {
             throw std::runtime_error("image source unsupported");
         },
     };
@@ -407,33 +638,41 @@ auto decodeImage(
     return image.data.visit(visitor);
 }
 
+// Images backing the default textures; white is shared by the sRGB and
+// linear white textures.
+enum DefaultImageIndex : std::uint32_t {
+    kImageWhite       = 0u,
+    kImageFlatNormals = 1u,
+
+    kDefaultImageCount = 2u,
+};
+
 auto makeDefaultTextures(RenderAsset &asset) -> void
 {
     const auto defaultSamplerInfo = makeDefaultSamplerInfo();
 
     {
-        Texture texture{};
-        texture.extent      = vk::Extent2D{1u, 1u};
-        texture.rgba8       = makePixel(255u, 255u, 255u, 255u);
-        texture.samplerInfo = defaultSamplerInfo;
-        asset.textures.push_back(std::move(texture));
+        TextureImage image{};
+        image.extent = vk::Extent2D{1u, 1u};
+        image.data   = makePixel(255u, 255u, 255u, 255u);
+        asset.images.push_back(std::move(image));
     }
 
     {
-        Texture texture{};
-        texture.extent      = vk::Extent2D{1u, 1u};
-        texture.rgba8       = makePixel(255u, 255u, 255u, 255u);
-        texture.samplerInfo = defaultSamplerInfo;
-        asset.textures.push_back(std::move(texture));
+        TextureImage image{};
+        image.extent = vk::Extent2D{1u, 1u};
+        image.data   = makePixel(128u, 128u, 255u, 255u);
+        asset.images.push_back(std::move(image));
     }
 
-    {
-        Texture texture{};
-        texture.extent      = vk::Extent2D{1u, 1u};
-        texture.rgba8       = makePixel(128u, 128u, 255u, 255u);
-        texture.samplerInfo = defaultSamplerInfo;
-        asset.textures.push_back(std::move(texture));
-    }
+    asset.textures.push_back(
+        Texture{.imageIndex = kImageWhite, .samplerInfo = defaultSamplerInfo});
+
+    asset.textures.push_back(
+        Texture{.imageIndex = kImageWhite, .samplerInfo = defaultSamplerInfo});
+
+    asset.textures.push_back(
+        Texture{.imageIndex = kImageFlatNormals, .samplerInfo = defaultSamplerInfo});
 }
 
 auto makeTextureRef(
@@ -456,27 +695,172 @@ auto loadTextures(
     RenderAsset                 &asset,
     const fastgltf::Asset       &gltfAsset,
     const std::filesystem::path &directory,
+    const AssetLoadOptions      &options,
     std::vector<std::uint32_t>  &texRemap) -> void
 {
     texRemap.clear();
     texRemap.resize(gltfAsset.textures.size(), 0u);
 
+    // Source images of a texture in order of preference: the KTX2 image of
+    // KHR_texture_basisu, then the core image, which is the fallback when
+    // the KTX2 payload cannot be used.
+    const auto textureSources = [](const fastgltf::Texture &gltfTexture) {
+        std::vector<std::size_t> sources{};
+
+        if (gltfTexture.basisuImageIndex.has_value()) {
+            sources.push_back(*gltfTexture.basisuImageIndex);
+        }
+
+        if (gltfTexture.imageIndex.has_value()) {
+            sources.push_back(*gltfTexture.imageIndex);
+        }
+
+        if (sources.empty()) {
+            throw std::runtime_error("texture missing image");
+        }
+
+        return sources;
+    };
+
+    // Decode cache keyed by glTF image index: each candidate source is
+    // decoded at most once, however many textures (samplers) point at it.
+    constexpr auto kUnreferencedImage = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<std::uint32_t> decodeSlots(gltfAsset.images.size(), kUnreferencedImage);
+    std::vector<std::size_t>   gltfImageIndices{};
+
+    // Images sampled as colour (through the sRGB views) are mip filtered in
+    // linear light; everything else is data.
+    std::vector<bool> srgbImages(gltfAsset.images.size(), false);
+
+    for (const fastgltf::Texture &gltfTexture : gltfAsset.textures) {
+        for (const std::size_t gltfImageIndex : textureSources(gltfTexture)) {
+            if (decodeSlots[gltfImageIndex] == kUnreferencedImage) {
+                decodeSlots[gltfImageIndex] =
+                    static_cast<std::uint32_t>(gltfImageIndices.size());
+
+                gltfImageIndices.push_back(gltfImageIndex);
+            }
+        }
+    }
+
+    const auto markSrgb = [&](const auto &textureInfo) {
+        if (!textureInfo.has_value()) {
+            return;
+        }
+
+        for (const std::size_t gltfImageIndex :
+             textureSources(gltfAsset.textures[textureInfo->textureIndex])) {
+            srgbImages[gltfImageIndex] = true;
+        }
+    };
+
+    for (const fastgltf::Material &gltfMaterial : gltfAsset.materials) {
+        markSrgb(gltfMaterial.pbrData.baseColorTexture);
+        markSrgb(gltfMaterial.emissiveTexture);
+    }
+
+    // Decode (and mip) on the worker pool, a round per preference rank:
+    // first every texture's primary source, then the next source only of
+    // textures whose earlier sources all failed, so a usable KTX2 image
+    // never pays for its fallback. Each result, or the reason it failed,
+    // lands in its own slot, so the output keeps glTF order regardless of
+    // which worker finishes first.
+    std::vector<TextureImage>               decodedImages(gltfImageIndices.size());
+    std::vector<std::optional<std::string>> decodeErrors(gltfImageIndices.size());
+    std::vector<bool>                       decodeQueued(gltfImageIndices.size(), false);
+
+    const auto decoded = [&](std::size_t gltfImageIndex) {
+        const std::uint32_t slot = decodeSlots[gltfImageIndex];
+
+        return decodeQueued[slot] && !decodeErrors[slot].has_value();
+    };
+
+    std::size_t maxSourceCount = 0u;
+
+    for (const fastgltf::Texture &gltfTexture : gltfAsset.textures) {
+        maxSourceCount = std::max(maxSourceCount, textureSources(gltfTexture).size());
+    }
+
+    for (std::size_t rank = 0u; rank < maxSourceCount; ++rank) {
+        std::vector<std::uint32_t> pendingSlots{};
+
+        for (const fastgltf::Texture &gltfTexture : gltfAsset.textures) {
+            const auto sources = textureSources(gltfTexture);
+
+            if (rank >= sources.size()
+                || std::ranges::any_of(sources | std::views::take(rank), decoded)) {
+                continue;
+            }
+
+            const std::uint32_t slot = decodeSlots[sources[rank]];
+
+            if (!decodeQueued[slot]) {
+                decodeQueued[slot] = true;
+                pendingSlots.push_back(slot);
+            }
+        }
+
+        parallelFor(pendingSlots.size(), [&](std::size_t pendingIndex) {
+            const std::uint32_t    slot           = pendingSlots[pendingIndex];
+            const std::size_t      gltfImageIndex = gltfImageIndices[slot];
+            const fastgltf::Image &gltfImage      = gltfAsset.images[gltfImageIndex];
+
+            try {
+                TextureImage image =
+                    decodeImage(gltfAsset, gltfImage, directory, options);
+
+                // KTX2 files bring their own levels
+                if (options.generateMipmaps && image.mipLevels == 1u
+                    && image.format == vk::Format::eR8G8B8A8Unorm) {
+                    generateMipChain(
+                        image,
+                        srgbImages[gltfImageIndex] ? MipColorSpace::kSrgb
+                                                   : MipColorSpace::kLinear);
+                }
+
+                decodedImages[slot] = std::move(image);
+            } catch (const std::exception &exception) {
+                decodeErrors[slot] = exception.what();
+            }
+        });
+    }
+
+    // Each texture uses its first source that decoded; only used images are
+    // kept, in order of first use.
+    std::vector<std::uint32_t> imageRemap(gltfAsset.images.size(), kUnreferencedImage);
+
+    asset.textures.reserve(asset.textures.size() + gltfAsset.textures.size());
+
     for (std::size_t textureIndex = 0u; textureIndex < gltfAsset.textures.size();
          ++textureIndex) {
 
         const fastgltf::Texture &gltfTexture = gltfAsset.textures[textureIndex];
 
-        if (!gltfTexture.imageIndex.has_value()) {
-            throw std::runtime_error("texture missing image");
+        const auto sources = textureSources(gltfTexture);
+
+        const auto chosen = std::ranges::find_if(sources, decoded);
+
+        if (chosen == sources.end()) {
+            throw std::runtime_error(*decodeErrors[decodeSlots[sources.front()]]);
         }
 
-        const fastgltf::Image &image = gltfAsset.images[*gltfTexture.imageIndex];
+        if (chosen != sources.begin()) {
+            fmt::println(
+                stderr,
+                "texture {}: {}; using the fallback image",
+                textureIndex,
+                *decodeErrors[decodeSlots[sources.front()]]);
+        }
 
-        DecodedImage decoded = decodeImage(gltfAsset, image, directory);
+        if (imageRemap[*chosen] == kUnreferencedImage) {
+            imageRemap[*chosen] = static_cast<std::uint32_t>(asset.images.size());
+
+            asset.images.push_back(std::move(decodedImages[decodeSlots[*chosen]]));
+        }
 
         Texture texture{};
-        texture.extent = decoded.extent;
-        texture.rgba8  = std::move(decoded.rgba8);
+        texture.imageIndex = imageRemap[*chosen];
 
         texture.samplerInfo = makeSamplerInfo(gltfTexture.samplerIndex, gltfAsset);
 
@@ -484,7 +868,7 @@ auto loadTextures(
 
         texRemap[textureIndex] = static_cast<std::uint32_t>(asset.textures.size());
 
-        asset.textures.push_back(std::move(texture));
+        asset.textures.push_back(texture);
     }
 }
 
@@ -579,6 +963,41 @@ auto loadMaterials(
     }
 }
 
+// Normalized integer texcoords (KHR_mesh_quantization) keep 16 bits; half
+// would move them by up to two texels on a 4K texture. Float and
+// unnormalized integer texcoords may leave [0, 1] and are stored as half.
+[[nodiscard]]
+auto uvEncodingForAccessor(const fastgltf::Accessor &accessor) -> std::uint32_t
+{
+    if (!accessor.normalized) {
+        return kUvEncodingHalf;
+    }
+
+    switch (accessor.componentType) {
+    case fastgltf::ComponentType::UnsignedByte:
+    case fastgltf::ComponentType::UnsignedShort:
+        return kUvEncodingUnorm16;
+    case fastgltf::ComponentType::Byte:
+    case fastgltf::ComponentType::Short:
+        return kUvEncodingSnorm16;
+    default:
+        return kUvEncodingHalf;
+    }
+}
+
+[[nodiscard]]
+auto packUv(glm::vec2 uv, std::uint32_t encoding) -> std::uint32_t
+{
+    switch (encoding) {
+    case kUvEncodingUnorm16:
+        return packUnorm2x16(uv);
+    case kUvEncodingSnorm16:
+        return packSnorm2x16(uv);
+    default:
+        return packHalf2(uv);
+    }
+}
+
 auto loadMeshes(
     RenderAsset                      &asset,
     const fastgltf::Asset            &gltfAsset,
@@ -632,46 +1051,54 @@ auto loadMeshes(
                     submesh.indices[idx] = index;
                 });
 
-            bool hasNormals  = false;
-            bool hasTangents = false;
+            // The normal and tangent are packed together once both are read.
+            std::vector<glm::vec3> normals{};
+            std::vector<glm::vec4> tangents{};
+
             for (auto &attribute : gltfPrimitive.attributes) {
                 auto &accessor = gltfAsset.accessors[attribute.accessorIndex];
 
                 if (attribute.name == "NORMAL") {
-                    hasNormals = true;
+                    normals.resize(submesh.vertices.size());
                     fastgltf::iterateAccessorWithIndex<glm::vec3>(
                         gltfAsset,
                         accessor,
                         [&](glm::vec3 normal, std::size_t idx) {
-                            submesh.vertices[idx].normal = normal;
+                            normals[idx] = normal;
                         });
                 }
 
                 else if (attribute.name == "TANGENT") {
-                    hasTangents = true;
+                    tangents.resize(submesh.vertices.size());
                     fastgltf::iterateAccessorWithIndex<glm::vec4>(
                         gltfAsset,
                         accessor,
                         [&](glm::vec4 tangent, std::size_t idx) {
-                            submesh.vertices[idx].tangent = tangent;
+                            tangents[idx] = tangent;
                         });
                 }
 
                 else if (attribute.name == "TEXCOORD_0") {
+                    const std::uint32_t encoding = uvEncodingForAccessor(accessor);
+                    submesh.uvEncoding |= encoding;
+
                     fastgltf::iterateAccessorWithIndex<glm::vec2>(
                         gltfAsset,
                         accessor,
                         [&](glm::vec2 uv, std::size_t idx) {
-                            submesh.vertices[idx].uv0 = uv;
+                            submesh.vertices[idx].uv0 = packUv(uv, encoding);
                         });
                 }
 
                 else if (attribute.name == "TEXCOORD_1") {
+                    const std::uint32_t encoding = uvEncodingForAccessor(accessor);
+                    submesh.uvEncoding |= encoding << 2u;
+
                     fastgltf::iterateAccessorWithIndex<glm::vec2>(
                         gltfAsset,
                         accessor,
                         [&](glm::vec2 uv, std::size_t idx) {
-                            submesh.vertices[idx].uv1 = uv;
+                            submesh.vertices[idx].uv1 = packUv(uv, encoding);
                         });
                 }
 
@@ -681,19 +1108,31 @@ auto loadMeshes(
                             gltfAsset,
                             accessor,
                             [&](glm::vec3 color, std::size_t idx) {
-                                submesh.vertices[idx].color = glm::vec4(color, 1.0f);
+                                submesh.vertices[idx].color =
+                                    packUnorm4(glm::vec4(color, 1.0f));
                             });
                     } else if (accessor.type == fastgltf::AccessorType::Vec4) {
                         fastgltf::iterateAccessorWithIndex<glm::vec4>(
                             gltfAsset,
                             accessor,
                             [&](glm::vec4 color, std::size_t idx) {
-                                submesh.vertices[idx].color = color;
+                                submesh.vertices[idx].color = packUnorm4(color);
                             });
                     }
                 }
             }
 
+            const bool hasNormals  = !normals.empty();
+            const bool hasTangents = !tangents.empty();
+
+            if (hasNormals) {
+                for (std::size_t idx = 0u; idx < submesh.vertices.size(); ++idx) {
+                    submesh.vertices[idx].normalTangent = packNormalTangent(
+                        normals[idx],
+                        hasTangents ? std::optional{tangents[idx]} : std::nullopt);
+                }
+            }
+
             submesh.tangentsValid = hasNormals && hasTangents;
             mesh.submeshes.push_back(std::move(submesh));
         }
@@ -815,14 +1254,15 @@ auto loadScenes(
 
 auto extractAsset(
     const fastgltf::Asset       &gltfAsset,
-    const std::filesystem::path &directory) -> RenderAsset
+    const std::filesystem::path &directory,
+    const AssetLoadOptions      &options) -> RenderAsset
 {
     RenderAsset asset{};
 
     makeDefaultTextures(asset);
 
     std::vector<std::uint32_t> texRemap{};
-    loadTextures(asset, gltfAsset, directory, texRemap);
+    loadTextures(asset, gltfAsset, directory, options, texRemap);
 
     std::vector<std::uint32_t> matRemap{};
     loadMaterials(asset, gltfAsset, texRemap, matRemap);
@@ -835,23 +1275,128 @@ auto extractAsset(
     return asset;
 }
 
-auto postProcessAsset(RenderAsset &) -> void
+auto postProcessAsset(
+    RenderAsset            &asset,
+    const AssetLoadOptions &options) -> void
 {
+    if (options.compressTextures) {
+        compressTextures(asset, options.textureFormats);
+    }
+
+    const MeshOptimizationOptions &meshOptions = options.meshOptimization;
+
+    if (meshOptions.vertexCache || meshOptions.vertexFetch) {
+        const VertexCacheStats stats = optimizeMeshes(asset.meshes, meshOptions);
+
+        if (stats.triangles != 0u) {
+            fmt::println(
+                stderr,
+                "mesh optimization: {} triangles, ACMR {:.3f} -> {:.3f}",
+                stats.triangles,
+                stats.acmrBefore(),
+                stats.acmrAfter());
+        }
+    }
+
     // TODO:
     // - Generate flat normals when missing.
     // - Generate tangents (MikkTSpace) when needed.
     // - Validate missing-normal magnitude heuristic.
 }
 
+// Identifies the load options that change the extracted asset, so a cooked
+// snapshot is not reused across them. memoryMapped and the cooked options
+// only affect how sources are read.
+auto cookedContentKey(const AssetLoadOptions &options) -> std::uint64_t
+{
+    std::uint64_t key = 0u;
+
+    if (options.generateMipmaps) {
+        key |= 1u << 0u;
+    }
+
+    if (options.compressTextures) {
+        key |= 1u << 1u;
+    }
+
+    if (options.meshOptimization.vertexCache) {
+        key |= 1u << 2u;
+    }
+
+    // only applies on top of the vertex cache order
+    if (options.meshOptimization.vertexCache && options.meshOptimization.overdraw) {
+        key |= 1u << 3u;
+    }
+
+    if (options.meshOptimization.vertexFetch) {
+        key |= 1u << 4u;
+    }
+
+    // transcoded and compressed texture formats follow the device
+    const TextureFormatSupport &formats = options.textureFormats;
+
+    if (formats.bc1) {
+        key |= 1u << 5u;
+    }
+
+    if (formats.bc3) {
+        key |= 1u << 6u;
+    }
+
+    if (formats.bc4) {
+        key |= 1u << 7u;
+    }
+
+    if (formats.bc5) {
+        key |= 1u << 8u;
+    }
+
+    if (formats.bc7) {
+        key |= 1u << 9u;
+    }
+
+    return key;
+}
+
 } // namespace
 
-auto getAsset(const std::filesystem::path &gltfPath) -> RenderAsset
+auto getAsset(
+    const std::filesystem::path &gltfPath,
+    const AssetLoadOptions      &options) -> RenderAsset
 {
-    const fastgltf::Asset gltfAsset = parseGltfAsset(gltfPath);
+    const auto directory = gltfPath.parent_path();
 
-    RenderAsset asset = extractAsset(gltfAsset, gltfPath.parent_path());
+    const auto cookedPath = options.cookedPath.empty()
+                              ? defaultCookedAssetPath(gltfPath)
+                              : options.cookedPath;
 
-    postProcessAsset(asset);
+    const auto contentKey = cookedContentKey(options);
+
+    if (options.useCookedAsset) {
+        if (auto cooked = readCookedAsset(cookedPath, directory, contentKey)) {
+            return std::move(*cooked);
+        }
+    }
+
+    const ParsedGltf parsed = parseGltfAsset(gltfPath, options);
+
+    RenderAsset asset = extractAsset(parsed.asset, directory, options);
+
+    postProcessAsset(asset, options);
+
+    if (options.useCookedAsset) {
+        // A failed write only costs the next startup a full load.
+        try {
+            writeCookedAsset(
+                cookedPath,
+                directory,
+                parsed.sourceFiles,
+                contentKey,
+                asset);
+        } catch (const std::exception &exception) {
+            fmt::println(stderr, "cooked asset not written: {}", exception.what());
+        }
+    }
 
     return asset;
 }
@@ -0,0 +1,140 @@
+#include "HostImageCopy.hpp"
+
+#include <algorithm>
+
+namespace
+{
+
+[[nodiscard]]
+auto copyDstLayouts(const PhysicalDevice &physicalDevice) -> std::vector<vk::ImageLayout>
+{
+    // two-call query: the layout array is filled by a second call
+    vk::PhysicalDeviceHostImageCopyProperties hostImageCopyProperties{};
+    vk::PhysicalDeviceProperties2             properties2{};
+    properties2.pNext = &hostImageCopyProperties;
+
+    const auto query = [&] {
+        physicalDevice.handle.getDispatcher()->vkGetPhysicalDeviceProperties2(
+            *physicalDevice.handle,
+            reinterpret_cast<VkPhysicalDeviceProperties2 *>(&properties2));
+    };
+
+    query();
+
+    std::vector<vk::ImageLayout> layouts(hostImageCopyProperties.copyDstLayoutCount);
+    hostImageCopyProperties.pCopyDstLayouts    = layouts.data();
+    hostImageCopyProperties.pCopySrcLayouts    = nullptr;
+    hostImageCopyProperties.copySrcLayoutCount = 0u;
+
+    query();
+
+    layouts.resize(hostImageCopyProperties.copyDstLayoutCount);
+
+    return layouts;
+}
+
+} // namespace
+
+HostImageCopy::HostImageCopy(
+    const PhysicalDevice &physicalDevice_,
+    Device               &device_)
+    : physicalDevice{physicalDevice_},
+      device{device_}
+{
+    // Device enables every supported core feature
+    const auto featureChain = physicalDevice.handle.getFeatures2<
+        vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDeviceVulkan14Features>();
+
+    if (!featureChain.get<vk::PhysicalDeviceVulkan14Features>().hostImageCopy) {
+        return;
+    }
+
+    enabled = std::ranges::contains(
+        copyDstLayouts(physicalDevice),
+        vk::ImageLayout::eShaderReadOnlyOptimal);
+}
+
+auto HostImageCopy::supports(const vk::ImageCreateInfo &imageInfo) const -> bool
+{
+    if (!enabled || imageInfo.tiling != vk::ImageTiling::eOptimal) {
+        return false;
+    }
+
+    const auto formatFeatures =
+        physicalDevice.handle
+            .getFormatProperties2<vk::FormatProperties2, vk::FormatProperties3>(
+                imageInfo.format)
+            .get<vk::FormatProperties3>()
+            .optimalTilingFeatures;
+
+    if (!(formatFeatures & vk::FormatFeatureFlagBits2::eHostImageTransfer)) {
+        return false;
+    }
+
+    try {
+        const auto propertiesChain = physicalDevice.handle.getImageFormatProperties2<
+            vk::ImageFormatProperties2,
+            vk::HostImageCopyDevicePerformanceQuery>(
+            vk::PhysicalDeviceImageFormatInfo2{
+                imageInfo.format,
+                imageInfo.imageType,
+                imageInfo.tiling,
+                imageInfo.usage | vk::ImageUsageFlagBits::eHostTransfer,
+                imageInfo.flags});
+
+        const auto &limits =
+            propertiesChain.get<vk::ImageFormatProperties2>().imageFormatProperties;
+
+        // a layout that is worse for the GPU would cost more per frame than
+        // the staging copy saves once
+        return propertiesChain.get<vk::HostImageCopyDevicePerformanceQuery>()
+                   .optimalDeviceAccess
+            && imageInfo.extent.width <= limits.maxExtent.width
+            && imageInfo.extent.height <= limits.maxExtent.height
+            && imageInfo.mipLevels <= limits.maxMipLevels
+            && imageInfo.arrayLayers <= limits.maxArrayLayers;
+    } catch (const vk::FormatNotSupportedError &) {
+        return false;
+    }
+}
+
+auto HostImageCopy::upload(
+    vk::Image           image,
+    const TextureImage &textureImage) const -> void
+{
+    device.handle.transitionImageLayout(
+        vk::HostImageLayoutTransitionInfo{
+            image,
+            vk::ImageLayout::eUndefined,
+            vk::ImageLayout::eShaderReadOnlyOptimal,
+            vk::ImageSubresourceRange{
+                vk::ImageAspectFlagBits::eColor,
+                0u,
+                textureImage.mipLevels,
+                0u,
+                1u}});
+
+    std::vector<vk::MemoryToImageCopy> regions{};
+    regions.reserve(textureImage.mipLevels);
+
+    for (uint32_t level = 0u; level < textureImage.mipLevels; ++level) {
+        const vk::Extent2D levelExtent = mipLevelExtent(textureImage.extent, level);
+
+        regions.push_back(
+            vk::MemoryToImageCopy{
+                textureImage.bytes().data() + textureImage.levelOffset(level),
+                0u,
+                0u,
+                vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, level, 0u, 1u},
+                vk::Offset3D{},
+                vk::Extent3D{levelExtent.width, levelExtent.height, 1u}});
+    }
+
+    device.handle.copyMemoryToImage(
+        vk::CopyMemoryToImageInfo{
+            {},
+            image,
+            vk::ImageLayout::eShaderReadOnlyOptimal,
+            regions});
+}
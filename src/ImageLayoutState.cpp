@@ -28,6 +28,15 @@ auto imageUseInfo(ImageUse use) -> ImageUseInfo
             .access = vk::AccessFlagBits2::eShaderSampledRead,
         };
 
+    case ImageUse::kComputeStorageReadWrite:
+        return ImageUseInfo{
+            .layout = vk::ImageLayout::eGeneral,
+            .stage  = vk::PipelineStageFlagBits2::eComputeShader,
+            .access = vk::AccessFlagBits2::eShaderStorageRead
+                    | vk::AccessFlagBits2::eShaderStorageWrite
+                    | vk::AccessFlagBits2::eShaderSampledRead,
+        };
+
     case ImageUse::kTransferDstWrite:
         return ImageUseInfo{
             .layout = vk::ImageLayout::eTransferDstOptimal,
@@ -0,0 +1,276 @@
+#include "Ktx2.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+#include <basisu_transcoder.h>
+
+namespace
+{
+
+constexpr std::array<std::uint8_t, 12> kKtx2Identifier{
+    0xABu,
+    0x4Bu,
+    0x54u,
+    0x58u,
+    0x20u,
+    0x32u,
+    0x30u,
+    0xBBu,
+    0x0Du,
+    0x0Au,
+    0x1Au,
+    0x0Au};
+
+constexpr std::uint32_t kSupercompressionNone = 0u;
+
+struct Ktx2Header {
+    std::array<std::uint8_t, 12> identifier{};
+
+    std::uint32_t vkFormat               = 0u;
+    std::uint32_t typeSize               = 0u;
+    std::uint32_t pixelWidth             = 0u;
+    std::uint32_t pixelHeight            = 0u;
+    std::uint32_t pixelDepth             = 0u;
+    std::uint32_t layerCount             = 0u;
+    std::uint32_t faceCount              = 0u;
+    std::uint32_t levelCount             = 0u;
+    std::uint32_t supercompressionScheme = 0u;
+
+    std::uint32_t dfdByteOffset = 0u;
+    std::uint32_t dfdByteLength = 0u;
+    std::uint32_t kvdByteOffset = 0u;
+    std::uint32_t kvdByteLength = 0u;
+    std::uint64_t sgdByteOffset = 0u;
+    std::uint64_t sgdByteLength = 0u;
+};
+
+static_assert(sizeof(Ktx2Header) == 80u);
+
+struct Ktx2Level {
+    std::uint64_t byteOffset             = 0u;
+    std::uint64_t byteLength             = 0u;
+    std::uint64_t uncompressedByteLength = 0u;
+};
+
+static_assert(sizeof(Ktx2Level) == 24u);
+
+// Formats stored as-is. The sRGB variants are stored as their UNORM twin:
+// textures are created with eMutableFormat and the material decides which
+// view samples them.
+[[nodiscard]]
+auto storageFormat(vk::Format format) -> vk::Format
+{
+    switch (format) {
+    case vk::Format::eR8G8B8A8Unorm:
+    case vk::Format::eR8G8B8A8Srgb:
+        return vk::Format::eR8G8B8A8Unorm;
+    case vk::Format::eBc1RgbUnormBlock:
+    case vk::Format::eBc1RgbSrgbBlock:
+        return vk::Format::eBc1RgbUnormBlock;
+    case vk::Format::eBc1RgbaUnormBlock:
+    case vk::Format::eBc1RgbaSrgbBlock:
+        return vk::Format::eBc1RgbaUnormBlock;
+    case vk::Format::eBc3UnormBlock:
+    case vk::Format::eBc3SrgbBlock:
+        return vk::Format::eBc3UnormBlock;
+    case vk::Format::eBc4UnormBlock:
+        return vk::Format::eBc4UnormBlock;
+    case vk::Format::eBc5UnormBlock:
+        return vk::Format::eBc5UnormBlock;
+    case vk::Format::eBc7UnormBlock:
+    case vk::Format::eBc7SrgbBlock:
+        return vk::Format::eBc7UnormBlock;
+    default:
+        return vk::Format::eUndefined;
+    }
+}
+
+struct TranscodeTarget {
+    basist::transcoder_texture_format basisFormat;
+    vk::Format                        format;
+};
+
+// Normal maps are stored as two channels (ETC1S: RRR + GGG slices, UASTC:
+// RG); those become BC5, everything else colour.
+[[nodiscard]]
+auto chooseTranscodeTarget(
+    const basist::ktx2_transcoder &transcoder,
+    const TextureFormatSupport    &formats) -> TranscodeTarget
+{
+    using basist::transcoder_texture_format;
+
+    const bool twoChannel =
+        transcoder.is_etc1s()
+            ? transcoder.get_dfd_channel_id1() == basist::KTX2_DF_CHANNEL_ETC1S_GGG
+            : transcoder.get_dfd_channel_id0() == basist::KTX2_DF_CHANNEL_UASTC_RG
+                  || transcoder.get_dfd_channel_id0() == basist::KTX2_DF_CHANNEL_UASTC_RRRG;
+
+    if (twoChannel && formats.bc5) {
+        return {transcoder_texture_format::cTFBC5_RG, vk::Format::eBc5UnormBlock};
+    }
+
+    if (formats.bc7) {
+        return {transcoder_texture_format::cTFBC7_RGBA, vk::Format::eBc7UnormBlock};
+    }
+
+    if (!twoChannel && !transcoder.get_has_alpha() && formats.bc1) {
+        return {transcoder_texture_format::cTFBC1_RGB, vk::Format::eBc1RgbUnormBlock};
+    }
+
+    return {transcoder_texture_format::cTFRGBA32, vk::Format::eR8G8B8A8Unorm};
+}
+
+[[nodiscard]]
+auto transcodeBasis(
+    std::span<const std::byte>  data,
+    const TextureFormatSupport &formats) -> TextureImage
+{
+    static std::once_flag initialized;
+    std::call_once(initialized, [] { basist::basisu_transcoder_init(); });
+
+    basist::ktx2_transcoder transcoder{};
+
+    if (data.size() > std::numeric_limits<std::uint32_t>::max()
+        || !transcoder.init(data.data(), static_cast<std::uint32_t>(data.size()))) {
+        throw std::runtime_error("KTX2: invalid Basis Universal file");
+    }
+
+    if (transcoder.get_layers() > 1u || transcoder.get_faces() != 1u) {
+        throw std::runtime_error("KTX2: only single 2D images are supported");
+    }
+
+    if (!transcoder.start_transcoding()) {
+        throw std::runtime_error("KTX2: Basis Universal payload unreadable");
+    }
+
+    const TranscodeTarget target = chooseTranscodeTarget(transcoder, formats);
+
+    TextureImage image{};
+    image.format    = target.format;
+    image.extent    = vk::Extent2D{transcoder.get_width(), transcoder.get_height()};
+    image.mipLevels = std::max(transcoder.get_levels(), 1u);
+
+    if (image.extent.width == 0u || image.extent.height == 0u
+        || image.mipLevels > fullMipLevelCount(image.extent)) {
+        throw std::runtime_error("KTX2: bad Basis Universal extent or levels");
+    }
+
+    image.data.resize(image.levelOffset(image.mipLevels));
+
+    const std::uint32_t bytesPerBlockOrPixel =
+        basist::basis_get_bytes_per_block_or_pixel(target.basisFormat);
+
+    for (std::uint32_t level = 0u; level < image.mipLevels; ++level) {
+        const auto blocksOrPixels =
+            static_cast<std::uint32_t>(image.levelBytes(level) / bytesPerBlockOrPixel);
+
+        if (!transcoder.transcode_image_level(
+                level,
+                0u,
+                0u,
+                image.data.data() + image.levelOffset(level),
+                blocksOrPixels,
+                target.basisFormat)) {
+            throw std::runtime_error("KTX2: Basis Universal transcode failed");
+        }
+    }
+
+    return image;
+}
+
+} // namespace
+
+auto isKtx2(std::span<const std::byte> data) -> bool
+{
+    return data.size() >= kKtx2Identifier.size()
+        && std::memcmp(data.data(), kKtx2Identifier.data(), kKtx2Identifier.size())
+               == 0;
+}
+
+auto readKtx2(
+    std::span<const std::byte>  data,
+    const TextureFormatSupport &formats) -> TextureImage
+{
+    if (!isKtx2(data) || data.size() < sizeof(Ktx2Header)) {
+        throw std::runtime_error("KTX2: not a KTX2 file");
+    }
+
+    Ktx2Header header{};
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    // VK_FORMAT_UNDEFINED marks a Basis Universal payload
+    if (header.vkFormat == 0u) {
+        return transcodeBasis(data, formats);
+    }
+
+    if (header.supercompressionScheme != kSupercompressionNone) {
+        throw std::runtime_error("KTX2: supercompressed native payload");
+    }
+
+    const vk::Format format = storageFormat(static_cast<vk::Format>(header.vkFormat));
+
+    if (format == vk::Format::eUndefined) {
+        throw std::runtime_error("KTX2: unsupported vkFormat");
+    }
+
+    if (!formats.supports(format)) {
+        throw std::runtime_error(
+            "KTX2: " + vk::to_string(format) + " cannot be sampled on this device");
+    }
+
+    if (header.pixelWidth == 0u || header.pixelHeight == 0u || header.pixelDepth > 1u
+        || header.layerCount > 1u || header.faceCount != 1u) {
+        throw std::runtime_error("KTX2: only single 2D images are supported");
+    }
+
+    TextureImage image{};
+    image.format    = format;
+    image.extent    = vk::Extent2D{header.pixelWidth, header.pixelHeight};
+    // 0 means the consumer generates the mips; the loader does so for RGBA8
+    image.mipLevels = std::max(header.levelCount, 1u);
+
+    if (image.mipLevels > fullMipLevelCount(image.extent)) {
+        throw std::runtime_error("KTX2: too many mip levels");
+    }
+
+    const std::size_t levelIndexEnd =
+        sizeof(Ktx2Header) + std::size_t{image.mipLevels} * sizeof(Ktx2Level);
+
+    if (data.size() < levelIndexEnd) {
+        throw std::runtime_error("KTX2: truncated level index");
+    }
+
+    image.data.reserve(image.levelOffset(image.mipLevels));
+
+    // the level index lists level 0 (largest) first
+    for (std::uint32_t level = 0u; level < image.mipLevels; ++level) {
+        Ktx2Level entry{};
+        std::memcpy(
+            &entry,
+            data.data() + sizeof(Ktx2Header) + level * sizeof(Ktx2Level),
+            sizeof(entry));
+
+        if (entry.byteLength != image.levelBytes(level)) {
+            throw std::runtime_error("KTX2: unexpected level size");
+        }
+
+        if (entry.byteOffset > data.size()
+            || data.size() - entry.byteOffset < entry.byteLength) {
+            throw std::runtime_error("KTX2: level out of bounds");
+        }
+
+        const auto levelData = data.subspan(
+            static_cast<std::size_t>(entry.byteOffset),
+            static_cast<std::size_t>(entry.byteLength));
+
+        image.data.insert(image.data.end(), levelData.begin(), levelData.end());
+    }
+
+    return image;
+}
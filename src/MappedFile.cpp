@@ -0,0 +1,187 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+{
+    HANDLE file = CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("MappedFile: cannot open " + path.string());
+    }
+
+    LARGE_INTEGER fileSize{};
+
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        throw std::runtime_error("MappedFile: cannot stat " + path.string());
+    }
+
+    fileHandle = file;
+    size       = static_cast<std::size_t>(fileSize.QuadPart);
+
+    // Zero-length files cannot be mapped; expose an empty span instead.
+    if (size == 0u) {
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (mapping == nullptr) {
+        unmap();
+        throw std::runtime_error("MappedFile: cannot map " + path.string());
+    }
+
+    mappingHandle = mapping;
+
+    const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (view == nullptr) {
+        unmap();
+        throw std::runtime_error("MappedFile: cannot map " + path.string());
+    }
+
+    data = static_cast<const std::byte *>(view);
+}
+
+auto MappedFile::unmap() noexcept -> void
+{
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+
+    if (mappingHandle != nullptr) {
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+    }
+
+    if (fileHandle != nullptr) {
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+    }
+
+    data          = nullptr;
+    size          = 0u;
+    mappingHandle = nullptr;
+    fileHandle    = nullptr;
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data{std::exchange(other.data, nullptr)},
+      size{std::exchange(other.size, 0u)},
+      fileHandle{std::exchange(other.fileHandle, nullptr)},
+      mappingHandle{std::exchange(other.mappingHandle, nullptr)}
+{
+}
+
+auto MappedFile::operator=(MappedFile &&other) noexcept -> MappedFile &
+{
+    if (this != &other) {
+        unmap();
+
+        data          = std::exchange(other.data, nullptr);
+        size          = std::exchange(other.size, 0u);
+        fileHandle    = std::exchange(other.fileHandle, nullptr);
+        mappingHandle = std::exchange(other.mappingHandle, nullptr);
+    }
+
+    return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        throw std::runtime_error("MappedFile: cannot open " + path.string());
+    }
+
+    struct stat fileStat {};
+
+    if (::fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MappedFile: cannot stat " + path.string());
+    }
+
+    size = static_cast<std::size_t>(fileStat.st_size);
+
+    // Zero-length files cannot be mapped; expose an empty span instead.
+    if (size == 0u) {
+        ::close(fd);
+        return;
+    }
+
+    void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+
+    if (mapping == MAP_FAILED) {
+        size = 0u;
+        throw std::runtime_error("MappedFile: cannot map " + path.string());
+    }
+
+    data = static_cast<const std::byte *>(mapping);
+}
+
+auto MappedFile::unmap() noexcept -> void
+{
+    if (data != nullptr) {
+        ::munmap(const_cast<std::byte *>(data), size);
+    }
+
+    data = nullptr;
+    size = 0u;
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data{std::exchange(other.data, nullptr)},
+      size{std::exchange(other.size, 0u)}
+{
+}
+
+auto MappedFile::operator=(MappedFile &&other) noexcept -> MappedFile &
+{
+    if (this != &other) {
+        unmap();
+
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0u);
+    }
+
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+auto MappedFile::bytes() const -> std::span<const std::byte>
+{
+    return {data, data != nullptr ? size : 0u};
+}
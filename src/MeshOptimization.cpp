@@ -0,0 +1,368 @@
+#include "MeshOptimization.hpp"
+
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+namespace
+{
+
+// FIFO entries assumed by Tipsify and by the ACMR measurement
+constexpr std::uint32_t kCacheSize = 16u;
+
+// Vertex shader invocations for indices on a FIFO cache of kCacheSize.
+[[nodiscard]]
+auto simulateFifoCache(
+    std::span<const std::uint32_t> indices,
+    std::size_t                    vertexCount) -> std::uint64_t
+{
+    // miss count at which each vertex entered the cache, 0 if never
+    std::vector<std::uint64_t> entered(vertexCount, 0u);
+
+    std::uint64_t misses = 0u;
+
+    for (const std::uint32_t index : indices) {
+        if (entered[index] != 0u && misses - entered[index] < kCacheSize) {
+            continue;
+        }
+
+        ++misses;
+        entered[index] = misses;
+    }
+
+    return misses;
+}
+
+struct TipsifyResult {
+    std::vector<std::uint32_t> indices;
+
+    // first triangle of each cluster; a cluster ends where Tipsify has to
+    // jump to a vertex that is not in the cache
+    std::vector<std::uint32_t> clusterStarts;
+};
+
+// Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and
+// Reduced Overdraw" (2007): fan around the oldest vertex still in the cache,
+// falling back to recently used vertices, then to input order.
+[[nodiscard]]
+auto tipsify(
+    std::span<const std::uint32_t> indices,
+    std::size_t                    vertexCount) -> TipsifyResult
+{
+    const std::size_t triangleCount = indices.size() / 3u;
+
+    // unemitted triangles per vertex
+    std::vector<std::uint32_t> liveTriangles(vertexCount, 0u);
+
+    for (const std::uint32_t index : indices) {
+        ++liveTriangles[index];
+    }
+
+    // vertex -> triangles, in input order
+    std::vector<std::uint32_t> adjacencyOffsets(vertexCount + 1u, 0u);
+
+    for (std::size_t vertex = 0u; vertex < vertexCount; ++vertex) {
+        adjacencyOffsets[vertex + 1u] = adjacencyOffsets[vertex] + liveTriangles[vertex];
+    }
+
+    std::vector<std::uint32_t> adjacency(indices.size());
+
+    {
+        std::vector<std::uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+        for (std::size_t corner = 0u; corner < indices.size(); ++corner) {
+            adjacency[fill[indices[corner]]++] = static_cast<std::uint32_t>(corner / 3u);
+        }
+    }
+
+    std::vector<std::uint32_t> cacheTime(vertexCount, 0u);
+    std::vector<bool>          emitted(triangleCount, false);
+
+    std::vector<std::uint32_t> deadEnds{};
+    std::vector<std::uint32_t> candidates{};
+
+    std::uint32_t time   = kCacheSize + 1u;
+    std::size_t   cursor = 0u;
+
+    TipsifyResult result{};
+    result.indices.reserve(indices.size());
+
+    const auto skipDeadEnd = [&]() -> std::optional<std::uint32_t> {
+        while (!deadEnds.empty()) {
+            const std::uint32_t vertex = deadEnds.back();
+            deadEnds.pop_back();
+
+            if (liveTriangles[vertex] > 0u) {
+                return vertex;
+            }
+        }
+
+        // every vertex before cursor is exhausted
+        while (cursor < vertexCount) {
+            const auto vertex = static_cast<std::uint32_t>(cursor++);
+
+            if (liveTriangles[vertex] > 0u) {
+                return vertex;
+            }
+        }
+
+        return std::nullopt;
+    };
+
+    std::optional<std::uint32_t> fan = skipDeadEnd();
+
+    while (fan.has_value()) {
+        candidates.clear();
+
+        for (std::uint32_t entry = adjacencyOffsets[*fan];
+             entry < adjacencyOffsets[*fan + 1u];
+             ++entry) {
+
+            const std::uint32_t triangle = adjacency[entry];
+
+            if (emitted[triangle]) {
+                continue;
+            }
+
+            emitted[triangle] = true;
+
+            for (std::uint32_t corner = 0u; corner < 3u; ++corner) {
+                const std::uint32_t vertex = indices[triangle * 3u + corner];
+
+                result.indices.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+
+                --liveTriangles[vertex];
+
+                if (time - cacheTime[vertex] > kCacheSize) {
+                    cacheTime[vertex] = time;
+                    ++time;
+                }
+            }
+        }
+
+        // the oldest candidate that stays cached while its fan is emitted;
+        // any live candidate beats a jump
+        std::optional<std::uint32_t> next;
+        std::int64_t                 bestPriority = -1;
+
+        for (const std::uint32_t vertex : candidates) {
+            if (liveTriangles[vertex] == 0u) {
+                continue;
+            }
+
+            std::int64_t priority = 0;
+
+            if (time - cacheTime[vertex] + 2u * liveTriangles[vertex] <= kCacheSize) {
+                priority = time - cacheTime[vertex];
+            }
+
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next         = vertex;
+            }
+        }
+
+        if (!next.has_value()) {
+            next = skipDeadEnd();
+
+            if (next.has_value()) {
+                result.clusterStarts.push_back(
+                    static_cast<std::uint32_t>(result.indices.size() / 3u));
+            }
+        }
+
+        fan = next;
+    }
+
+    if (!result.indices.empty()) {
+        result.clusterStarts.insert(result.clusterStarts.begin(), 0u);
+    }
+
+    return result;
+}
+
+// Sort clusters by how far they face out from the mesh centroid, largest
+// first (Sander et al., section 4). Cluster contents keep their order, so
+// cache efficiency only changes at cluster boundaries.
+auto sortClustersForOverdraw(
+    TipsifyResult                 &tipsified,
+    const std::vector<MeshVertex> &vertices) -> void
+{
+    const std::vector<std::uint32_t> &clusterStarts = tipsified.clusterStarts;
+
+    if (clusterStarts.size() < 2u) {
+        return;
+    }
+
+    const auto triangleCount = static_cast<std::uint32_t>(tipsified.indices.size() / 3u);
+
+    const auto clusterEnd = [&](std::size_t cluster) {
+        return cluster + 1u < clusterStarts.size() ? clusterStarts[cluster + 1u]
+                                                   : triangleCount;
+    };
+
+    std::vector<glm::vec3> centroids(clusterStarts.size(), glm::vec3{0.0f});
+    std::vector<glm::vec3> normals(clusterStarts.size(), glm::vec3{0.0f});
+    std::vector<float>     areas(clusterStarts.size(), 0.0f);
+
+    glm::vec3 meshCentroid{0.0f};
+    float     meshArea = 0.0f;
+
+    for (std::size_t cluster = 0u; cluster < clusterStarts.size(); ++cluster) {
+        for (std::uint32_t triangle = clusterStarts[cluster]; triangle < clusterEnd(cluster);
+             ++triangle) {
+
+            const glm::vec3 &p0 = vertices[tipsified.indices[triangle * 3u + 0u]].position;
+            const glm::vec3 &p1 = vertices[tipsified.indices[triangle * 3u + 1u]].position;
+            const glm::vec3 &p2 = vertices[tipsified.indices[triangle * 3u + 2u]].position;
+
+            // twice the area, pointing along the face normal
+            const glm::vec3 areaNormal = glm::cross(p1 - p0, p2 - p0);
+            const float     area       = glm::length(areaNormal);
+
+            centroids[cluster] += area * (p0 + p1 + p2) / 3.0f;
+            normals[cluster] += areaNormal;
+            areas[cluster] += area;
+        }
+
+        meshCentroid += centroids[cluster];
+        meshArea += areas[cluster];
+    }
+
+    if (meshArea <= 0.0f) {
+        return;
+    }
+
+    meshCentroid /= meshArea;
+
+    std::vector<float> sortKeys(clusterStarts.size(), 0.0f);
+
+    for (std::size_t cluster = 0u; cluster < clusterStarts.size(); ++cluster) {
+        const float normalLength = glm::length(normals[cluster]);
+
+        if (areas[cluster] <= 0.0f || normalLength <= 0.0f) {
+            continue;
+        }
+
+        sortKeys[cluster] =
+            glm::dot(centroids[cluster] / areas[cluster] - meshCentroid,
+                     normals[cluster] / normalLength);
+    }
+
+    std::vector<std::uint32_t> order(clusterStarts.size());
+    std::iota(order.begin(), order.end(), 0u);
+
+    std::ranges::stable_sort(order, std::ranges::greater{}, [&](std::uint32_t cluster) {
+        return sortKeys[cluster];
+    });
+
+    std::vector<std::uint32_t> sorted{};
+    sorted.reserve(tipsified.indices.size());
+
+    for (const std::uint32_t cluster : order) {
+        sorted.insert(
+            sorted.end(),
+            tipsified.indices.begin() + clusterStarts[cluster] * 3u,
+            tipsified.indices.begin() + clusterEnd(cluster) * 3u);
+    }
+
+    tipsified.indices = std::move(sorted);
+}
+
+// Renumber vertices in order of first use.
+auto remapVertexFetch(Submesh &submesh) -> void
+{
+    constexpr auto kUnused = ~std::uint32_t{0u};
+
+    std::vector<std::uint32_t> remap(submesh.vertices.size(), kUnused);
+
+    std::vector<MeshVertex> vertices{};
+    vertices.reserve(submesh.vertices.size());
+
+    for (std::uint32_t &index : submesh.indices) {
+        if (remap[index] == kUnused) {
+            remap[index] = static_cast<std::uint32_t>(vertices.size());
+            vertices.push_back(submesh.vertices[index]);
+        }
+
+        index = remap[index];
+    }
+
+    submesh.vertices = std::move(vertices);
+}
+
+[[nodiscard]]
+auto isOptimizable(const Submesh &submesh) -> bool
+{
+    if (submesh.topology != vk::PrimitiveTopology::eTriangleList
+        || submesh.indices.empty() || submesh.indices.size() % 3u != 0u) {
+        return false;
+    }
+
+    return std::ranges::max(submesh.indices) < submesh.vertices.size();
+}
+
+} // namespace
+
+auto optimizeMeshes(
+    std::vector<Mesh>             &meshes,
+    const MeshOptimizationOptions &options) -> VertexCacheStats
+{
+    std::vector<Submesh *> submeshes{};
+
+    for (Mesh &mesh : meshes) {
+        for (Submesh &submesh : mesh.submeshes) {
+            if (isOptimizable(submesh)) {
+                submeshes.push_back(&submesh);
+            }
+        }
+    }
+
+    // per-submesh slots, summed in order afterwards
+    std::vector<VertexCacheStats> submeshStats(submeshes.size());
+
+    parallelFor(submeshes.size(), [&](std::size_t slot) {
+        Submesh          &submesh = *submeshes[slot];
+        VertexCacheStats &stats   = submeshStats[slot];
+
+        stats.triangles = submesh.indices.size() / 3u;
+        stats.transformsBefore =
+            simulateFifoCache(submesh.indices, submesh.vertices.size());
+
+        if (options.vertexCache) {
+            TipsifyResult tipsified = tipsify(submesh.indices, submesh.vertices.size());
+
+            if (options.overdraw) {
+                sortClustersForOverdraw(tipsified, submesh.vertices);
+            }
+
+            submesh.indices = std::move(tipsified.indices);
+        }
+
+        // after reordering, so first use follows the final triangle order
+        if (options.vertexFetch) {
+            remapVertexFetch(submesh);
+        }
+
+        stats.transformsAfter = simulateFifoCache(submesh.indices, submesh.vertices.size());
+    });
+
+    VertexCacheStats total{};
+
+    for (const VertexCacheStats &stats : submeshStats) {
+        total.triangles += stats.triangles;
+        total.transformsBefore += stats.transformsBefore;
+        total.transformsAfter += stats.transformsAfter;
+    }
+
+    return total;
+}
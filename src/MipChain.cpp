@@ -0,0 +1,264 @@
+#include "MipChain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NIENNA_MIP_SSE2 1
+#include <emmintrin.h>
+#else
+#define NIENNA_MIP_SSE2 0
+#endif
+
+namespace
+{
+
+constexpr std::size_t kChannels = 4u;
+
+// linear -> sRGB lookup resolution; fine enough that the darkest sRGB steps
+// are not merged
+constexpr std::size_t kEncodeTableSize = 1u << 16u;
+
+struct SrgbTables {
+    std::array<float, 256>    decode{};
+    std::vector<std::uint8_t> encode;
+};
+
+[[nodiscard]]
+auto srgbToLinear(float value) -> float
+{
+    return value <= 0.04045f ? value / 12.92f
+                             : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+[[nodiscard]]
+auto linearToSrgb(float value) -> float
+{
+    return value <= 0.0031308f ? value * 12.92f
+                               : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+[[nodiscard]]
+auto toUnorm8(float value) -> std::uint8_t
+{
+    return static_cast<std::uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+[[nodiscard]]
+auto srgbTables() -> const SrgbTables &
+{
+    static const SrgbTables tables = [] {
+        SrgbTables result{};
+
+        for (std::size_t value = 0u; value < result.decode.size(); ++value) {
+            result.decode[value] = srgbToLinear(static_cast<float>(value) / 255.0f);
+        }
+
+        result.encode.resize(kEncodeTableSize);
+
+        for (std::size_t index = 0u; index < kEncodeTableSize; ++index) {
+            const float linear =
+                static_cast<float>(index) / static_cast<float>(kEncodeTableSize - 1u);
+
+            result.encode[index] = toUnorm8(linearToSrgb(linear));
+        }
+
+        return result;
+    }();
+
+    return tables;
+}
+
+// Source texels [first, first + count) and their weights for one
+// destination texel along one axis.
+struct FilterTaps {
+    std::uint32_t        first = 0u;
+    std::uint32_t        count = 0u;
+    std::array<float, 3> weights{};
+};
+
+// Box filter taps from sourceSize down to mipLevelExtent's halved size.
+// For odd sizes 2n + 1 -> n, destination i covers source [2i, 2i + 3) with
+// weights (n - i, n, i + 1) / (2n + 1): the footprints tile the source.
+[[nodiscard]]
+auto makeFilterTaps(
+    std::uint32_t sourceSize,
+    std::uint32_t destinationSize) -> std::vector<FilterTaps>
+{
+    std::vector<FilterTaps> taps(destinationSize);
+
+    if (sourceSize == 1u) {
+        taps.front() = FilterTaps{.first = 0u, .count = 1u, .weights = {1.0f}};
+        return taps;
+    }
+
+    if (sourceSize % 2u == 0u) {
+        for (std::uint32_t i = 0u; i < destinationSize; ++i) {
+            taps[i] = FilterTaps{.first = 2u * i, .count = 2u, .weights = {0.5f, 0.5f}};
+        }
+
+        return taps;
+    }
+
+    const float n     = static_cast<float>(destinationSize);
+    const float scale = 1.0f / static_cast<float>(sourceSize);
+
+    for (std::uint32_t i = 0u; i < destinationSize; ++i) {
+        const float fi = static_cast<float>(i);
+
+        taps[i] = FilterTaps{
+            .first   = 2u * i,
+            .count   = 3u,
+            .weights = {(n - fi) * scale, n * scale, (fi + 1.0f) * scale},
+        };
+    }
+
+    return taps;
+}
+
+// out[0, floatCount) = sum over t of taps.weights[t] * sources[t][...];
+// floatCount is a multiple of kChannels. Used for whole rows (vertical
+// pass) and single RGBA texels (horizontal pass).
+auto weightedSum(
+    const std::array<const float *, 3> &sources,
+    const FilterTaps                   &taps,
+    float                              *out,
+    std::size_t                         floatCount) -> void
+{
+#if NIENNA_MIP_SSE2
+    for (std::size_t i = 0u; i < floatCount; i += kChannels) {
+        __m128 sum = _mm_mul_ps(_mm_set1_ps(taps.weights[0]), _mm_loadu_ps(sources[0] + i));
+
+        for (std::uint32_t t = 1u; t < taps.count; ++t) {
+            sum = _mm_add_ps(
+                sum,
+                _mm_mul_ps(_mm_set1_ps(taps.weights[t]), _mm_loadu_ps(sources[t] + i)));
+        }
+
+        _mm_storeu_ps(out + i, sum);
+    }
+#else
+    for (std::size_t i = 0u; i < floatCount; ++i) {
+        float sum = taps.weights[0] * sources[0][i];
+
+        for (std::uint32_t t = 1u; t < taps.count; ++t) {
+            sum += taps.weights[t] * sources[t][i];
+        }
+
+        out[i] = sum;
+    }
+#endif
+}
+
+} // namespace
+
+auto generateMipChain(
+    TextureImage &image,
+    MipColorSpace colorSpace) -> void
+{
+    if (image.format != vk::Format::eR8G8B8A8Unorm) {
+        throw std::invalid_argument("generateMipChain: RGBA8 images only");
+    }
+
+    const std::uint32_t levelCount = fullMipLevelCount(image.extent);
+
+    image.mipLevels = 1u;
+    image.data.resize(image.levelBytes(0u));
+
+    if (levelCount == 1u) {
+        return;
+    }
+
+    const SrgbTables &tables = srgbTables();
+    const bool        srgb   = colorSpace == MipColorSpace::kSrgb;
+
+    // alpha is never sRGB-encoded
+    const auto isColorChannel = [&](std::size_t channel) {
+        return srgb && channel < 3u;
+    };
+
+    std::vector<float> source(image.data.size());
+
+    for (std::size_t index = 0u; index < source.size(); ++index) {
+        const auto value = std::to_integer<std::uint8_t>(image.data[index]);
+
+        source[index] = isColorChannel(index % kChannels)
+                          ? tables.decode[value]
+                          : static_cast<float>(value) / 255.0f;
+    }
+
+    image.data.reserve(image.levelOffset(levelCount));
+
+    std::vector<float> columns{};
+    std::vector<float> destination{};
+    vk::Extent2D       sourceExtent = image.extent;
+
+    for (std::uint32_t level = 1u; level < levelCount; ++level) {
+        const vk::Extent2D extent = mipLevelExtent(image.extent, level);
+
+        const std::size_t sourceRowFloats = std::size_t{sourceExtent.width} * kChannels;
+        const std::size_t rowFloats       = std::size_t{extent.width} * kChannels;
+
+        // vertical pass: source rows -> destination height, source width
+        columns.resize(sourceRowFloats * extent.height);
+
+        const auto rowTaps = makeFilterTaps(sourceExtent.height, extent.height);
+
+        for (std::uint32_t y = 0u; y < extent.height; ++y) {
+            const FilterTaps &taps = rowTaps[y];
+
+            std::array<const float *, 3> rows{};
+
+            for (std::uint32_t t = 0u; t < taps.count; ++t) {
+                rows[t] = source.data() + (taps.first + t) * sourceRowFloats;
+            }
+
+            weightedSum(rows, taps, columns.data() + y * sourceRowFloats, sourceRowFloats);
+        }
+
+        // horizontal pass: one RGBA texel at a time
+        destination.resize(rowFloats * extent.height);
+
+        const auto columnTaps = makeFilterTaps(sourceExtent.width, extent.width);
+
+        for (std::uint32_t y = 0u; y < extent.height; ++y) {
+            const float *row = columns.data() + y * sourceRowFloats;
+            float       *out = destination.data() + y * rowFloats;
+
+            for (std::uint32_t x = 0u; x < extent.width; ++x) {
+                const FilterTaps &taps = columnTaps[x];
+
+                std::array<const float *, 3> texels{};
+
+                for (std::uint32_t t = 0u; t < taps.count; ++t) {
+                    texels[t] = row + (taps.first + t) * kChannels;
+                }
+
+                weightedSum(texels, taps, out + x * kChannels, kChannels);
+            }
+        }
+
+        for (std::size_t index = 0u; index < destination.size(); ++index) {
+            const float value = destination[index];
+
+            const std::uint8_t encoded =
+                isColorChannel(index % kChannels)
+                    ? tables.encode[static_cast<std::size_t>(
+                          std::clamp(value, 0.0f, 1.0f)
+                              * static_cast<float>(kEncodeTableSize - 1u)
+                          + 0.5f)]
+                    : toUnorm8(value);
+
+            image.data.push_back(std::byte{encoded});
+        }
+
+        source.swap(destination);
+        sourceExtent = extent;
+    }
+
+    image.mipLevels = levelCount;
+}
@@ -0,0 +1,148 @@
+#include "NodeInstanceStore.hpp"
+
+#include "Utility.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+
+constexpr uint32_t kBitsPerWord = 64u;
+
+} // namespace
+
+NodeInstanceStore::NodeInstanceStore(
+    std::vector<NodeInstanceData> instances_,
+    uint32_t                      frameSlotCount)
+    : instances{std::move(instances_)},
+      dirtyBits(frameSlotCount),
+      uploadedGenerations(frameSlotCount, 0u),
+      changedFlags(instances.size(), false)
+{
+    for (uint32_t frameSlot = 0u; frameSlot < frameSlotCount; ++frameSlot) {
+        markAllDirty(frameSlot);
+    }
+}
+
+auto NodeInstanceStore::markAllDirty(uint32_t frameSlot) -> void
+{
+    const auto count     = static_cast<uint32_t>(instances.size());
+    const auto wordCount = (count + kBitsPerWord - 1u) / kBitsPerWord;
+
+    auto &bits = dirtyBits[frameSlot];
+    bits.assign(wordCount, ~uint64_t{0u});
+
+    // no bits past the last instance
+    if (const uint32_t tail = count % kBitsPerWord; tail != 0u) {
+        bits.back() = (uint64_t{1u} << tail) - 1u;
+    }
+}
+
+auto NodeInstanceStore::set(
+    uint32_t                index,
+    const NodeInstanceData &instance) -> void
+{
+    instances[index] = instance;
+
+    const uint64_t mask = uint64_t{1u} << (index % kBitsPerWord);
+
+    for (auto &bits : dirtyBits) {
+        bits[index / kBitsPerWord] |= mask;
+    }
+
+    if (!changedFlags[index]) {
+        changedFlags[index] = true;
+        changedInstances.push_back(index);
+    }
+}
+
+auto NodeInstanceStore::takeChangedInstances() -> std::vector<uint32_t>
+{
+    for (const uint32_t index : changedInstances) {
+        changedFlags[index] = false;
+    }
+
+    return std::exchange(changedInstances, {});
+}
+
+auto NodeInstanceStore::upload(
+    const Allocator &allocator,
+    uint32_t         frameSlot,
+    const Buffer    &ssbo,
+    uint64_t         bufferGeneration) -> vk::DeviceSize
+{
+    if (uploadedGenerations[frameSlot] != bufferGeneration) {
+        markAllDirty(frameSlot);
+        uploadedGenerations[frameSlot] = bufferGeneration;
+    }
+
+    auto &bits = dirtyBits[frameSlot];
+
+    VmaAllocationInfo allocationInfo{};
+    vmaGetAllocationInfo(allocator.handle(), ssbo.allocation, &allocationInfo);
+
+    auto *mapped = static_cast<std::byte *>(allocationInfo.pMappedData);
+
+    if (mapped == nullptr && !instances.empty()) {
+        throw std::runtime_error("NodeInstanceStore: SSBO is not host mapped");
+    }
+
+    vk::DeviceSize bytesWritten = 0u;
+
+    const auto copyRange = [&](uint32_t first, uint32_t end) {
+        const auto offset = static_cast<vk::DeviceSize>(first) * sizeof(NodeInstanceData);
+        const auto bytes =
+            static_cast<vk::DeviceSize>(end - first) * sizeof(NodeInstanceData);
+
+        std::memcpy(mapped + offset, instances.data() + first, bytes);
+
+        // no-op on host-coherent memory
+        VK_CHECK(vmaFlushAllocation(allocator.handle(), ssbo.allocation, offset, bytes));
+
+        bytesWritten += bytes;
+    };
+
+    bool     rangeOpen  = false;
+    uint32_t rangeFirst = 0u;
+    uint32_t rangeEnd   = 0u;
+
+    for (uint32_t wordIndex = 0u; wordIndex < bits.size(); ++wordIndex) {
+        uint64_t word = bits[wordIndex];
+
+        if (word == 0u) {
+            continue;
+        }
+
+        bits[wordIndex] = 0u;
+
+        while (word != 0u) {
+            const uint32_t index =
+                wordIndex * kBitsPerWord + static_cast<uint32_t>(std::countr_zero(word));
+
+            if (rangeOpen && index <= rangeEnd + kMergeGap) {
+                rangeEnd = index + 1u;
+            } else {
+                if (rangeOpen) {
+                    copyRange(rangeFirst, rangeEnd);
+                }
+
+                rangeOpen  = true;
+                rangeFirst = index;
+                rangeEnd   = index + 1u;
+            }
+
+            // clear the lowest set bit
+            word &= word - 1u;
+        }
+    }
+
+    if (rangeOpen) {
+        copyRange(rangeFirst, rangeEnd);
+    }
+
+    return bytesWritten;
+}
@@ -0,0 +1,81 @@
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+auto workerThreadCount() -> std::size_t
+{
+    const auto hardwareThreads =
+        static_cast<std::size_t>(std::thread::hardware_concurrency());
+
+    return std::max<std::size_t>(hardwareThreads, 1u);
+}
+
+auto parallelFor(
+    std::size_t                              count,
+    const std::function<void(std::size_t)> &body) -> void
+{
+    if (count == 0u) {
+        return;
+    }
+
+    const std::size_t threadCount = std::min(workerThreadCount(), count);
+
+    // Nothing to fan out; avoid spawning a thread for a single item.
+    if (threadCount == 1u) {
+        for (std::size_t index = 0u; index < count; ++index) {
+            body(index);
+        }
+
+        return;
+    }
+
+    std::atomic<std::size_t> nextIndex{0u};
+    std::atomic<bool>        failed{false};
+
+    std::exception_ptr firstException{};
+    std::mutex         exceptionMutex;
+
+    const auto worker = [&] {
+        while (!failed.load(std::memory_order_relaxed)) {
+            const std::size_t index =
+                nextIndex.fetch_add(1u, std::memory_order_relaxed);
+
+            if (index >= count) {
+                return;
+            }
+
+            try {
+                body(index);
+            } catch (...) {
+                const std::lock_guard lock{exceptionMutex};
+
+                if (!firstException) {
+                    firstException = std::current_exception();
+                }
+
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    {
+        // The calling thread takes part as well, so spawn one fewer.
+        std::vector<std::jthread> workers;
+        workers.reserve(threadCount - 1u);
+
+        for (std::size_t i = 1u; i < threadCount; ++i) {
+            workers.emplace_back(worker);
+        }
+
+        worker();
+    }
+
+    if (firstException) {
+        std::rethrow_exception(firstException);
+    }
+}
@@ -4,10 +4,12 @@
 
 auto createPipeline(
     Device                      &device,
+    const PipelineCache         &pipelineCache,
     const std::filesystem::path &shaderPath,
     vk::Format                   imageFormat,
     vk::Format                   depthFormat,
-    vk::raii::PipelineLayout    &pipelineLayout) -> vk::raii::Pipeline
+    vk::raii::PipelineLayout    &pipelineLayout,
+    vk::PipelineCreateFlags      flags) -> vk::raii::Pipeline
 {
     auto shaderModule = createShaderModule(device.handle, shaderPath);
 
@@ -44,31 +46,25 @@ auto createPipeline(
         vk::VertexInputAttributeDescription{
             1u,
             0u,
-            vk::Format::eR32G32B32Sfloat,
-            static_cast<std::uint32_t>(offsetof(MeshVertex, normal)),
+            vk::Format::eR16G16B16A16Snorm,
+            static_cast<std::uint32_t>(offsetof(MeshVertex, normalTangent)),
         },
         vk::VertexInputAttributeDescription{
             2u,
             0u,
-            vk::Format::eR32G32B32A32Sfloat,
-            static_cast<std::uint32_t>(offsetof(MeshVertex, tangent)),
-        },
-        vk::VertexInputAttributeDescription{
-            3u,
-            0u,
-            vk::Format::eR32G32Sfloat,
+            vk::Format::eR16G16Uint,
             static_cast<std::uint32_t>(offsetof(MeshVertex, uv0)),
         },
         vk::VertexInputAttributeDescription{
-            4u,
+            3u,
             0u,
-            vk::Format::eR32G32Sfloat,
+            vk::Format::eR16G16Uint,
             static_cast<std::uint32_t>(offsetof(MeshVertex, uv1)),
         },
         vk::VertexInputAttributeDescription{
-            5u,
+            4u,
             0u,
-            vk::Format::eR32G32B32A32Sfloat,
+            vk::Format::eR8G8B8A8Unorm,
             static_cast<std::uint32_t>(offsetof(MeshVertex, color)),
         },
     };
@@ -134,10 +130,17 @@ auto createPipeline(
             &colorBlendAttachmentState,
         };
 
+    // cull mode, front face, depth write and blending are per-draw material
+    // state (RasterState); the values above are only defaults
     const auto dynamicStates = std::array{
         vk::DynamicState::eViewportWithCount,
         vk::DynamicState::eScissorWithCount,
         vk::DynamicState::ePolygonModeEXT,
+        vk::DynamicState::eCullMode,
+        vk::DynamicState::eFrontFace,
+        vk::DynamicState::eDepthWriteEnable,
+        vk::DynamicState::eColorBlendEnableEXT,
+        vk::DynamicState::eColorBlendEquationEXT,
     };
 
     const auto pipelineDynamicStateCreateInfo = vk::PipelineDynamicStateCreateInfo{
@@ -152,7 +155,7 @@ auto createPipeline(
     };
 
     auto graphicsPipelineCreateInfo = vk::GraphicsPipelineCreateInfo{
-        {},
+        flags,
         shaderStages,
         &vertexInputStateCreateInfo,
         &inputAssemblyCreateInfo,
@@ -173,7 +176,7 @@ auto createPipeline(
 
     return vk::raii::Pipeline{
         device.handle,
-        nullptr,
+        pipelineCache.handle,
         graphicsPipelineCreateInfo,
     };
 }
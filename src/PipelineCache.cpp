@@ -0,0 +1,174 @@
+#include "PipelineCache.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/base.h>
+
+#include "MappedFile.hpp"
+#include "Utility.hpp"
+
+namespace
+{
+
+constexpr std::array<char, 8> kPipelineCacheMagic{
+    'N', 'I', 'E', 'N', 'P', 'S', 'O', '\0'};
+
+// Bump when PipelineCacheFileHeader changes.
+constexpr std::uint32_t kPipelineCacheFileVersion = 1u;
+
+struct PipelineCacheFileHeader {
+    std::array<char, 8>                    magic{};
+    std::uint32_t                          fileVersion   = 0u;
+    std::uint32_t                          vendorID      = 0u;
+    std::uint32_t                          deviceID      = 0u;
+    std::uint32_t                          driverVersion = 0u;
+    std::array<std::uint8_t, vk::UuidSize> pipelineCacheUUID{};
+    std::uint64_t                          dataSize = 0u;
+    std::uint64_t                          dataHash = 0u;
+};
+
+static_assert(std::is_trivially_copyable_v<PipelineCacheFileHeader>);
+
+[[nodiscard]]
+auto makeHeader(
+    const vk::PhysicalDeviceProperties &properties,
+    std::span<const std::byte>          data) -> PipelineCacheFileHeader
+{
+    auto header = PipelineCacheFileHeader{
+        .magic         = kPipelineCacheMagic,
+        .fileVersion   = kPipelineCacheFileVersion,
+        .vendorID      = properties.vendorID,
+        .deviceID      = properties.deviceID,
+        .driverVersion = properties.driverVersion,
+        .dataSize      = data.size(),
+        .dataHash      = fnv1a(data),
+    };
+
+    std::memcpy(
+        header.pipelineCacheUUID.data(),
+        properties.pipelineCacheUUID.data(),
+        vk::UuidSize);
+
+    return header;
+}
+
+// The blob must also start with the driver's own header for this device.
+[[nodiscard]]
+auto hasMatchingDriverHeader(
+    const vk::PhysicalDeviceProperties &properties,
+    std::span<const std::byte>          data) -> bool
+{
+    VkPipelineCacheHeaderVersionOne driverHeader{};
+
+    if (data.size() < sizeof(driverHeader)) {
+        return false;
+    }
+
+    std::memcpy(&driverHeader, data.data(), sizeof(driverHeader));
+
+    return driverHeader.headerSize >= sizeof(driverHeader)
+        && driverHeader.headerSize <= data.size()
+        && driverHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        && driverHeader.vendorID == properties.vendorID
+        && driverHeader.deviceID == properties.deviceID
+        && std::memcmp(
+               driverHeader.pipelineCacheUUID,
+               properties.pipelineCacheUUID.data(),
+               vk::UuidSize)
+               == 0;
+}
+
+} // namespace
+
+PipelineCache::PipelineCache(
+    const PhysicalDevice &physicalDevice,
+    Device               &device,
+    std::filesystem::path path_)
+    : path{std::move(path_)},
+      deviceProperties{physicalDevice.handle.getProperties()}
+{
+    const auto initialData = load();
+
+    handle = vk::raii::PipelineCache{
+        device.handle,
+        vk::PipelineCacheCreateInfo{
+            {},
+            initialData.size(),
+            initialData.data(),
+        }};
+}
+
+auto PipelineCache::load() const -> std::vector<std::byte>
+{
+    std::error_code errorCode;
+
+    if (path.empty() || !std::filesystem::exists(path, errorCode)) {
+        return {};
+    }
+
+    try {
+        const auto file  = MappedFile{path};
+        const auto bytes = file.bytes();
+
+        PipelineCacheFileHeader header{};
+
+        if (bytes.size() < sizeof(header)) {
+            return {};
+        }
+
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        const auto data = bytes.subspan(sizeof(header));
+
+        const auto expected = makeHeader(deviceProperties, {});
+
+        const bool valid =
+            header.magic == expected.magic && header.fileVersion == expected.fileVersion
+            && header.vendorID == expected.vendorID
+            && header.deviceID == expected.deviceID
+            && header.driverVersion == expected.driverVersion
+            && header.pipelineCacheUUID == expected.pipelineCacheUUID
+            && header.dataSize == data.size() && header.dataHash == fnv1a(data)
+            && hasMatchingDriverHeader(deviceProperties, data);
+
+        if (!valid) {
+            fmt::println(stderr, "Ignoring stale pipeline cache {}", path.string());
+            return {};
+        }
+
+        return std::vector<std::byte>(data.begin(), data.end());
+    } catch (const std::exception &e) {
+        fmt::println(stderr, "Ignoring unreadable pipeline cache: {}", e.what());
+        return {};
+    }
+}
+
+auto PipelineCache::save() const -> void
+{
+    if (path.empty()) {
+        return;
+    }
+
+    try {
+        const auto data  = handle.getData();
+        const auto bytes = std::as_bytes(std::span{data});
+
+        const auto header = makeHeader(deviceProperties, bytes);
+
+        if (path.has_parent_path()) {
+            std::filesystem::create_directories(path.parent_path());
+        }
+
+        // a crash mid-write never leaves a truncated cache behind
+        writeFileAtomically(path, {std::as_bytes(std::span{&header, 1u}), bytes});
+    } catch (const std::exception &e) {
+        fmt::println(stderr, "Failed to save pipeline cache: {}", e.what());
+    }
+}
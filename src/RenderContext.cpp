@@ -4,7 +4,10 @@
 
 RenderContext::RenderContext(
     Window                          &window,
-    const std::vector<const char *> &requiredExtensions)
+    const std::vector<const char *> &requiredExtensions,
+    const std::vector<const char *> &optionalExtensions,
+    const std::filesystem::path     &pipelineCachePath,
+    vk::DeviceSize                   stagingBytes)
     : instance{},
       surface{
           instance,
@@ -16,11 +19,24 @@ RenderContext::RenderContext(
           physicalDevice,
           window,
           surface,
-          requiredExtensions},
+          requiredExtensions,
+          optionalExtensions},
+      hostImageCopy{
+          physicalDevice,
+          device},
+      pipelineCache{
+          physicalDevice,
+          device,
+          pipelineCachePath},
       allocator{
           instance,
           physicalDevice,
           device},
+      uploadQueue{
+          physicalDevice,
+          device,
+          allocator,
+          stagingBytes},
       swapchain{
           device,
           physicalDevice,
@@ -0,0 +1,154 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <numeric>
+#include <utility>
+
+namespace
+{
+
+constexpr std::uint32_t kDigitBits  = 8u;
+constexpr std::uint32_t kDigitCount = 64u / kDigitBits;
+constexpr std::uint32_t kRadix      = 1u << kDigitBits;
+
+[[nodiscard]]
+auto saturate16(std::uint32_t value) -> std::uint64_t
+{
+    return std::min(value, 0xFFFFu);
+}
+
+[[nodiscard]]
+auto viewDepthOf(
+    const glm::mat4 &viewMatrix,
+    const glm::vec3 &worldPosition) -> float
+{
+    // -z of the view-space position (right-handed view, camera looks down -z)
+    return -(viewMatrix[0][2] * worldPosition.x + viewMatrix[1][2] * worldPosition.y
+             + viewMatrix[2][2] * worldPosition.z + viewMatrix[3][2]);
+}
+
+} // namespace
+
+auto makeDrawSortKey(
+    const DrawSortInfo &info,
+    float               viewDepth) -> std::uint64_t
+{
+    // non-negative floats order like their bit patterns; bit 31 stays clear
+    const float         clampedDepth = viewDepth > 0.0f ? viewDepth : 0.0f;
+    const std::uint32_t depthBits    = std::bit_cast<std::uint32_t>(clampedDepth);
+
+    const std::uint64_t material = saturate16(info.materialIndex);
+    const std::uint64_t geometry = saturate16(info.geometryIndex);
+
+    std::uint64_t key = static_cast<std::uint64_t>(info.bucket) << 62u;
+    key |= static_cast<std::uint64_t>(info.pipelineState & 0x3Fu) << 56u;
+
+    if (info.bucket == RenderBucket::kBlended) {
+        const std::uint64_t depth24 = depthBits >> 7u;
+
+        key |= (0xFFFFFFu - depth24) << 32u;
+        key |= material << 16u;
+        key |= geometry;
+
+        return key;
+    }
+
+    const std::uint64_t exponent = (depthBits >> 23u) & 0xFFu;
+    const std::uint64_t mantissa = (depthBits >> 7u) & 0xFFFFu;
+
+    key |= exponent << 48u;
+    key |= material << 32u;
+    key |= geometry << 16u;
+    key |= mantissa;
+
+    return key;
+}
+
+auto RenderQueue::build(
+    std::span<const DrawSortInfo>  sortInfos,
+    std::span<const std::uint32_t> drawIndices,
+    const glm::mat4               &viewMatrix) -> void
+{
+    keys.resize(drawIndices.size());
+    indices.assign(drawIndices.begin(), drawIndices.end());
+
+    for (std::size_t i = 0u; i < indices.size(); ++i) {
+        const DrawSortInfo &info = sortInfos[indices[i]];
+
+        keys[i] = makeDrawSortKey(info, viewDepthOf(viewMatrix, info.worldCenter));
+    }
+
+    sort();
+}
+
+auto RenderQueue::buildAll(
+    std::span<const DrawSortInfo> sortInfos,
+    const glm::mat4              &viewMatrix) -> void
+{
+    keys.resize(sortInfos.size());
+    indices.resize(sortInfos.size());
+
+    std::iota(indices.begin(), indices.end(), 0u);
+
+    for (std::size_t i = 0u; i < sortInfos.size(); ++i) {
+        keys[i] = makeDrawSortKey(
+            sortInfos[i],
+            viewDepthOf(viewMatrix, sortInfos[i].worldCenter));
+    }
+
+    sort();
+}
+
+// LSD radix sort of (key, index) pairs, one byte per pass. All histograms
+// come from a single read of the keys; passes whose byte is the same for
+// every key (typically the bucket/state bytes) are skipped. Stable, so
+// equal keys keep traversal order.
+auto RenderQueue::sort() -> void
+{
+    const std::size_t count = keys.size();
+
+    if (count < 2u) {
+        return;
+    }
+
+    std::array<std::array<std::uint32_t, kRadix>, kDigitCount> histograms{};
+
+    for (const std::uint64_t key : keys) {
+        for (std::uint32_t digit = 0u; digit < kDigitCount; ++digit) {
+            ++histograms[digit][(key >> (digit * kDigitBits)) & (kRadix - 1u)];
+        }
+    }
+
+    scratchKeys.resize(count);
+    scratchIndices.resize(count);
+
+    for (std::uint32_t digit = 0u; digit < kDigitCount; ++digit) {
+        auto &histogram = histograms[digit];
+
+        const std::uint32_t shift = digit * kDigitBits;
+        const std::uint32_t first = (keys[0] >> shift) & (kRadix - 1u);
+
+        if (histogram[first] == count) {
+            continue;
+        }
+
+        // counts -> starting offsets
+        std::uint32_t offset = 0u;
+
+        for (std::uint32_t &bucket : histogram) {
+            offset += std::exchange(bucket, offset);
+        }
+
+        for (std::size_t i = 0u; i < count; ++i) {
+            const std::uint32_t slot = histogram[(keys[i] >> shift) & (kRadix - 1u)]++;
+
+            scratchKeys[slot]    = keys[i];
+            scratchIndices[slot] = indices[i];
+        }
+
+        keys.swap(scratchKeys);
+        indices.swap(scratchIndices);
+    }
+}
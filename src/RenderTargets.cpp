@@ -1,7 +1,10 @@
 #include "RenderTargets.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 
+#include "DescriptorSources.hpp"
 #include "Device.hpp"
 #include "Utility.hpp"
 
@@ -33,6 +36,12 @@ auto depthAspectMask(vk::Format fmt) -> vk::ImageAspectFlags
     }
 }
 
+[[nodiscard]]
+auto previousPowerOfTwo(uint32_t value) -> uint32_t
+{
+    return value == 0u ? 1u : std::bit_floor(value);
+}
+
 } // namespace
 
 RenderTargetAllocator::RenderTargetAllocator(VmaAllocator vma)
@@ -41,6 +50,9 @@ RenderTargetAllocator::RenderTargetAllocator(VmaAllocator vma)
           nullptr,
           VmaPoolDeleter(vma)},
       depthPool{
+          nullptr,
+          VmaPoolDeleter(vma)},
+      storagePool{
           nullptr,
           VmaPoolDeleter(vma)}
 {
@@ -58,7 +70,9 @@ auto RenderTargetAllocator::ensurePool(
 {
     assert(vmaAllocator != nullptr);
 
-    auto &pool = (kind == PoolKind::kColor) ? colorPool : depthPool;
+    auto &pool = (kind == PoolKind::kColor)   ? colorPool
+               : (kind == PoolKind::kDepth) ? depthPool
+                                            : storagePool;
 
     if (pool) {
         return pool.get();
@@ -161,10 +175,22 @@ auto ColorTarget::range() const -> vk::ImageSubresourceRange
 auto DepthTarget::recreate(
     Device                &device,
     RenderTargetAllocator &alloc,
-    vk::Extent2D           extent,
-    vk::Format             depthFormat) -> void
+    vk::Extent2D           extent_,
+    vk::Format             depthFormat,
+    bool                   sampled) -> void
 {
+    // views reference the old image
+    sampledView = nullptr;
+    view        = nullptr;
+
     format = depthFormat;
+    extent = extent_;
+
+    auto usage = vk::ImageUsageFlags{vk::ImageUsageFlagBits::eDepthStencilAttachment};
+
+    if (sampled) {
+        usage |= vk::ImageUsageFlagBits::eSampled;
+    }
 
     const vk::ImageCreateInfo info{
         {},
@@ -175,7 +201,7 @@ auto DepthTarget::recreate(
         1,
         vk::SampleCountFlagBits::e1,
         vk::ImageTiling::eOptimal,
-        vk::ImageUsageFlagBits::eDepthStencilAttachment,
+        usage,
     };
 
     image = alloc.createImage(info, RenderTargetAllocator::PoolKind::kDepth);
@@ -189,6 +215,20 @@ auto DepthTarget::recreate(
             {},
             range(),
         });
+
+    if (!sampled) {
+        return;
+    }
+
+    sampledView = device.handle.createImageView(
+        vk::ImageViewCreateInfo{
+            {},
+            image.get(),
+            vk::ImageViewType::e2D,
+            format,
+            {},
+            vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eDepth, 0, 1, 0, 1},
+        });
 }
 
 auto DepthTarget::range() const -> vk::ImageSubresourceRange
@@ -204,6 +244,79 @@ auto DepthTarget::range() const -> vk::ImageSubresourceRange
     };
 }
 
+auto DepthPyramidTarget::recreate(
+    Device                &device,
+    RenderTargetAllocator &alloc,
+    vk::Extent2D           depthExtent) -> void
+{
+    // views reference the old image
+    levelViews.clear();
+    view = nullptr;
+
+    extent = vk::Extent2D{
+        previousPowerOfTwo(depthExtent.width),
+        previousPowerOfTwo(depthExtent.height),
+    };
+
+    levelCount = static_cast<uint32_t>(
+        std::bit_width(std::max(extent.width, extent.height)));
+
+    const vk::ImageCreateInfo info{
+        {},
+        vk::ImageType::e2D,
+        kFormat,
+        vk::Extent3D{extent.width, extent.height, 1},
+        levelCount,
+        1,
+        vk::SampleCountFlagBits::e1,
+        vk::ImageTiling::eOptimal,
+        vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled,
+    };
+
+    image = alloc.createImage(info, RenderTargetAllocator::PoolKind::kStorage);
+
+    view = device.handle.createImageView(
+        vk::ImageViewCreateInfo{
+            {},
+            image.get(),
+            vk::ImageViewType::e2D,
+            kFormat,
+            {},
+            range(),
+        });
+
+    levelViews.reserve(levelCount);
+
+    for (uint32_t level = 0u; level < levelCount; ++level) {
+        levelViews.emplace_back(device.handle.createImageView(
+            vk::ImageViewCreateInfo{
+                {},
+                image.get(),
+                vk::ImageViewType::e2D,
+                kFormat,
+                {},
+                vk::ImageSubresourceRange{
+                    vk::ImageAspectFlagBits::eColor,
+                    level,
+                    1,
+                    0,
+                    1,
+                },
+            }));
+    }
+}
+
+auto DepthPyramidTarget::range() const -> vk::ImageSubresourceRange
+{
+    return vk::ImageSubresourceRange{
+        vk::ImageAspectFlagBits::eColor,
+        0,
+        levelCount,
+        0,
+        1,
+    };
+}
+
 RenderTargets::RenderTargets(
     Device      &device,
     VmaAllocator vma,
@@ -221,14 +334,42 @@ auto RenderTargets::recreate(
     vk::Format   swapchainFormat,
     vk::Format   depthFormat) -> void
 {
-    extent = extent_;
+    extent     = extent_;
+    generation = nextDescriptorSourceGeneration();
 
     sceneColorLdr.recreate(device, allocator, extent_, swapchainFormat);
 
-    mainDepth.recreate(device, allocator, extent_, depthFormat);
+    mainDepth.recreate(device, allocator, extent_, depthFormat, depthPyramidEnabled);
+
+    if (depthPyramidEnabled) {
+        mainDepthPyramid.recreate(device, allocator, extent_);
+    }
+}
+
+auto RenderTargets::enableDepthPyramid(Device &device) -> void
+{
+    if (depthPyramidEnabled) {
+        return;
+    }
+
+    depthPyramidEnabled = true;
+    generation          = nextDescriptorSourceGeneration();
+
+    mainDepth.recreate(device, allocator, extent, mainDepth.format, true);
+
+    mainDepthPyramid.recreate(device, allocator, extent);
 }
 
 auto RenderTargets::images() const -> std::vector<vk::Image>
 {
-    return std::vector<vk::Image>{sceneColorLdr.image.get(), mainDepth.image.get()};
+    auto result = std::vector<vk::Image>{
+        sceneColorLdr.image.get(),
+        mainDepth.image.get(),
+    };
+
+    if (depthPyramidEnabled) {
+        result.push_back(mainDepthPyramid.image.get());
+    }
+
+    return result;
 }
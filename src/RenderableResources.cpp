@@ -1,14 +1,25 @@
 #include "RenderableResources.hpp"
 
+#include "AABB.hpp"
+#include "DescriptorSources.hpp"
 #include "MaterialPacking.hpp"
+#include "Parallel.hpp"
 #include "RenderAsset.hpp"
 #include "SceneView.hpp"
 #include "ShaderInterfaceTypes.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <numeric>
 #include <ranges>
+#include <span>
+#include <stdexcept>
 #include <vector>
 
+#include <fmt/base.h>
+
 namespace
 {
 
@@ -60,32 +71,189 @@ auto getOrCreateSamplerIndex(
     return uniqueSamplerIndex;
 }
 
-} // namespace
-auto RenderableResources::create(
+[[nodiscard]]
+auto makeDrawSortInfo(
+    const RenderAsset &asset,
+    const DrawItem    &draw,
+    const RasterState &rasterState,
+    const AABB        &worldAABB) -> DrawSortInfo
+{
+    // draws without a material use the default one, like packMaterialData
+    const MaterialCore core = draw.materialIndex < asset.materials.size()
+                                ? asset.materials[draw.materialIndex].core
+                                : MaterialCore{};
+
+    auto info = DrawSortInfo{
+        .worldCenter   = worldAABB.isValid() ? 0.5f * (worldAABB.min + worldAABB.max)
+                                             : glm::vec3{0.0f},
+        .materialIndex = draw.materialIndex,
+        .geometryIndex = draw.geometryIndex,
+    };
+
+    if (core.alphaBlendEnable) {
+        info.bucket = RenderBucket::kBlended;
+    } else if (core.alphaMaskEnable) {
+        info.bucket = RenderBucket::kMasked;
+    }
+
+    if (rasterState.cullMode == vk::CullModeFlagBits::eNone) {
+        info.pipelineState |= kPipelineStateDoubleSided;
+    }
+
+    if (rasterState.frontFace == vk::FrontFace::eClockwise) {
+        info.pipelineState |= kPipelineStateMirrored;
+    }
+
+    return info;
+}
+
+[[nodiscard]]
+auto makeDrawRasterState(
     const RenderAsset &asset,
     const SceneView   &sceneView,
-    Device            &device,
-    Command           &command,
-    Allocator         &allocator) -> void
+    const DrawItem    &draw) -> RasterState
+{
+    const MaterialCore core = draw.materialIndex < asset.materials.size()
+                                ? asset.materials[draw.materialIndex].core
+                                : MaterialCore{};
+
+    const glm::mat4 &modelMatrix =
+        sceneView.nodeInstances[draw.nodeInstanceIndex].modelMatrix;
+
+    return makeRasterState(core, glm::determinant(glm::mat3{modelMatrix}) < 0.0f);
+}
+
+// sRGB view format for a UNORM texture storage format; formats without an
+// sRGB twin (BC4/BC5 data) are viewed as stored.
+[[nodiscard]]
+auto srgbViewFormat(vk::Format format) -> vk::Format
+{
+    switch (format) {
+    case vk::Format::eR8G8B8A8Unorm:
+        return vk::Format::eR8G8B8A8Srgb;
+    case vk::Format::eBc1RgbUnormBlock:
+        return vk::Format::eBc1RgbSrgbBlock;
+    case vk::Format::eBc1RgbaUnormBlock:
+        return vk::Format::eBc1RgbaSrgbBlock;
+    case vk::Format::eBc3UnormBlock:
+        return vk::Format::eBc3SrgbBlock;
+    case vk::Format::eBc7UnormBlock:
+        return vk::Format::eBc7SrgbBlock;
+    default:
+        return format;
+    }
+}
+
+// Stands in for images whose format this device cannot sample.
+[[nodiscard]]
+auto placeholderImage() -> const TextureImage &
+{
+    static const TextureImage image = [] {
+        TextureImage result{};
+        result.extent = vk::Extent2D{1u, 1u};
+        result.data.assign(4u, std::byte{0xFFu});
+
+        return result;
+    }();
+
+    return image;
+}
+
+} // namespace
+auto RenderableResources::create(
+    const RenderAsset   &asset,
+    const SceneView     &sceneView,
+    Device              &device,
+    UploadQueue         &uploads,
+    const HostImageCopy &hostImageCopy,
+    Allocator           &allocator) -> void
 {
-    draws = sceneView.draws;
+    generation = nextDescriptorSourceGeneration();
+
+    draws.clear();
+    drawRasterStates.clear();
+    rasterStateGroups.clear();
+
+    // group draws by raster state, then index type; each state (and its
+    // matrix determinant) is built once, and the stable sort keeps
+    // traversal order inside a group
+    std::vector<RasterState>   sceneRasterStates{};
+    std::vector<std::uint32_t> sortKeys{};
+    sceneRasterStates.reserve(sceneView.draws.size());
+    sortKeys.reserve(sceneView.draws.size());
+
+    for (const DrawItem &draw : sceneView.draws) {
+        const RasterState state = makeDrawRasterState(asset, sceneView, draw);
+
+        sceneRasterStates.push_back(state);
+        sortKeys.push_back(
+            state.key() << 1u
+            | static_cast<std::uint32_t>(draw.indexType == vk::IndexType::eUint32));
+    }
+
+    std::vector<std::uint32_t> drawOrder(sceneView.draws.size());
+    std::iota(drawOrder.begin(), drawOrder.end(), 0u);
+
+    std::ranges::stable_sort(drawOrder, {}, [&](std::uint32_t sceneDrawIndex) {
+        return sortKeys[sceneDrawIndex];
+    });
+
+    draws.reserve(drawOrder.size());
+    drawRasterStates.reserve(drawOrder.size());
+
+    for (const std::uint32_t sceneDrawIndex : drawOrder) {
+        draws.push_back(sceneView.draws[sceneDrawIndex]);
+        drawRasterStates.push_back(sceneRasterStates[sceneDrawIndex]);
+    }
+
+    for (const auto &[drawIndex, draw] : std::views::enumerate(draws)) {
+        const RasterState &state = drawRasterStates[drawIndex];
+
+        if (rasterStateGroups.empty() || rasterStateGroups.back().state != state
+            || rasterStateGroups.back().indexType != draw.indexType) {
+            rasterStateGroups.push_back(
+                RasterStateGroup{
+                    .state     = state,
+                    .indexType = draw.indexType,
+                    .firstDraw = static_cast<std::uint32_t>(drawIndex),
+                });
+        }
+
+        ++rasterStateGroups.back().drawCount;
+    }
+
+    const auto firstBlended =
+        std::ranges::find_if(drawRasterStates, [](const RasterState &state) {
+            return state.blendEnable != vk::False;
+        });
+
+    firstBlendedDraw = static_cast<std::uint32_t>(
+        std::distance(drawRasterStates.begin(), firstBlended));
 
-    vertexBuffers.clear();
-    indexBuffers.clear();
+    vertexBuffer  = Buffer{};
+    indexBuffer   = Buffer{};
+    index32Offset = 0u;
+    geometryRanges.clear();
 
-    // meshOffsets.back() is the total primitive count
-    // const auto primitiveCount = meshOffsets.back();
-    //
-    // vertexBuffers.reserve(primitiveCount);
-    // indexBuffers.reserve(primitiveCount);
+    indirectCommandsBuffer = Buffer{};
+    drawDataSSBO           = Buffer{};
+    indirectDrawCount      = 0u;
+    drawBoundsSSBO         = Buffer{};
+    worldDrawBounds.clear();
+    localDrawBounds.clear();
+    instanceDrawOffsets.clear();
+    instanceDraws.clear();
+    drawSortInfos.clear();
 
     textureImages.clear();
     srgbTextureImageViews.clear();
     linearTextureImageViews.clear();
+    textureImageIndices.clear();
 
-    textureImages.reserve(asset.textures.size());
-    srgbTextureImageViews.reserve(asset.textures.size());
-    linearTextureImageViews.reserve(asset.textures.size());
+    textureImages.reserve(asset.images.size());
+    srgbTextureImageViews.reserve(asset.images.size());
+    linearTextureImageViews.reserve(asset.images.size());
+    textureImageIndices.reserve(asset.textures.size());
 
     samplerHandles.clear();
     uniqueSamplers.clear();
@@ -93,21 +261,216 @@ auto RenderableResources::create(
 
     samplerHandles.resize(asset.textures.size());
 
-    command.beginSingleTime();
+    // Lay every submesh out in one vertex and one index buffer, in geometry
+    // index order (mesh-major, as SceneView assigns them). Indices stay local
+    // to their submesh; draws add vertexOffset. Submeshes of up to 64Ki
+    // vertices store 16-bit indices.
+    {
+        std::size_t vertexCount  = 0u;
+        std::size_t index16Count = 0u;
+        std::size_t index32Count = 0u;
+
+        for (const auto &mesh : asset.meshes) {
+            for (const auto &primitive : mesh.submeshes) {
+                const auto indexType = submeshIndexType(primitive);
+
+                std::size_t &sectionCount =
+                    indexType == vk::IndexType::eUint16 ? index16Count : index32Count;
+
+                geometryRanges.push_back(
+                    GeometryRange{
+                        .firstIndex   = static_cast<std::uint32_t>(sectionCount),
+                        .indexCount   = static_cast<std::uint32_t>(primitive.indexCount()),
+                        .vertexOffset = static_cast<std::int32_t>(vertexCount),
+                        .indexType    = indexType,
+                    });
+
+                vertexCount += primitive.vertexCount();
+                sectionCount += primitive.indexCount();
+            }
+        }
+
+        constexpr auto maxVertexOffset =
+            static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+
+        if (vertexCount > maxVertexOffset
+            || index16Count + index32Count > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error("scene geometry exceeds 32-bit draw offsets");
+        }
+
+        if (vertexCount != 0u && index16Count + index32Count != 0u) {
+            vertexBuffer = allocator.createBuffer(
+                vertexCount * sizeof(MeshVertex),
+                vk::BufferUsageFlagBits2::eVertexBuffer
+                    | vk::BufferUsageFlagBits2::eTransferDst,
+                false,
+                VMA_MEMORY_USAGE_GPU_ONLY);
+
+            // the 32-bit section starts 4-byte aligned
+            index32Offset = (index16Count * sizeof(std::uint16_t) + sizeof(std::uint32_t) - 1u)
+                          & ~vk::DeviceSize{sizeof(std::uint32_t) - 1u};
+
+            indexBuffer = allocator.createBuffer(
+                index32Offset + index32Count * sizeof(std::uint32_t),
+                vk::BufferUsageFlagBits2::eIndexBuffer
+                    | vk::BufferUsageFlagBits2::eTransferDst,
+                false,
+                VMA_MEMORY_USAGE_GPU_ONLY);
+
+            // Each submesh is staged straight from the asset; for a cooked
+            // asset that is the file mapping, so nothing is copied on the heap.
+            std::vector<std::uint16_t> narrowedIndices{};
+            std::size_t                geometryIndex = 0u;
+
+            for (const auto &mesh : asset.meshes) {
+                for (const auto &primitive : mesh.submeshes) {
+                    const GeometryRange &range = geometryRanges[geometryIndex++];
+
+                    const vk::DeviceSize indexBytes =
+                        range.indexType == vk::IndexType::eUint16 ? sizeof(std::uint16_t)
+                                                                  : sizeof(std::uint32_t);
+
+                    uploads.uploadBuffer(
+                        std::as_bytes(primitive.vertexData()),
+                        vertexBuffer.buffer,
+                        static_cast<vk::DeviceSize>(range.vertexOffset) * sizeof(MeshVertex));
+
+                    uploads.uploadBuffer(
+                        gpuIndexBytes(primitive, narrowedIndices),
+                        indexBuffer.buffer,
+                        indexBufferOffset(range.indexType) + range.firstIndex * indexBytes);
+                }
+            }
+
+            uploads.releaseBuffer(vertexBuffer.buffer);
+            uploads.releaseBuffer(indexBuffer.buffer);
+        }
+    }
+
+    for (DrawItem &draw : draws) {
+        const GeometryRange &range = geometryRanges[draw.geometryIndex];
 
-    // TODO: create large geometry buffers to "flatten out" vertex/indexBuffers
-    for (const auto &mesh : asset.meshes) {
-        for (const auto &primitive : mesh.submeshes) {
+        draw.firstIndex   = range.firstIndex;
+        draw.vertexOffset = range.vertexOffset;
+        draw.indexType    = range.indexType;
+    }
+
+    {
+        std::vector<vk::DrawIndexedIndirectCommand> commands{};
+        std::vector<DrawData>                       drawData{};
+        std::vector<DrawBounds>                     drawBounds{};
+
+        commands.reserve(draws.size());
+        drawData.reserve(draws.size());
+        drawBounds.reserve(draws.size());
+        worldDrawBounds.reserve(draws.size());
+        localDrawBounds.reserve(draws.size());
+        drawSortInfos.reserve(draws.size());
+
+        auto groupIterator = rasterStateGroups.cbegin();
+
+        for (const auto &[drawIndex, draw] : std::views::enumerate(draws)) {
+            if (static_cast<std::uint32_t>(drawIndex)
+                >= groupIterator->firstDraw + groupIterator->drawCount) {
+                ++groupIterator;
+            }
+
+            const std::uint32_t groupFirstDraw = groupIterator->firstDraw;
+
+            commands.push_back(
+                vk::DrawIndexedIndirectCommand{
+                    draw.indexCount,
+                    1u,
+                    draw.firstIndex,
+                    draw.vertexOffset,
+                    static_cast<std::uint32_t>(drawIndex),
+                });
+
+            drawData.push_back(
+                DrawData{
+                    .nodeInstanceIndex = draw.nodeInstanceIndex,
+                    .materialIndex     = draw.materialIndex,
+                    .uvEncoding        = draw.uvEncoding,
+                });
+
+            auto localAABB = computeLocalAABB(
+                asset.meshes[draw.meshIndex].submeshes[draw.submeshIndex]);
+
+            const AABB worldAABB = computeWorldAABBFromLocalAABB(
+                localAABB,
+                sceneView.nodeInstances[draw.nodeInstanceIndex].modelMatrix);
+
+            worldDrawBounds.push(worldAABB);
+            localDrawBounds.push_back(localAABB);
+
+            drawSortInfos.push_back(makeDrawSortInfo(
+                asset,
+                draw,
+                drawRasterStates[drawIndex],
+                worldAABB));
+
+            // empty submeshes draw nothing; any bounds will do
+            if (!localAABB.isValid()) {
+                localAABB = AABB{};
+            }
+
+            drawBounds.push_back(
+                DrawBounds{
+                    .localMin          = localAABB.min,
+                    .nodeInstanceIndex = draw.nodeInstanceIndex,
+                    .localMax          = localAABB.max,
+                    .groupFirstDraw    = groupFirstDraw,
+                });
+        }
+
+        indirectDrawCount = static_cast<std::uint32_t>(commands.size());
 
-            vertexBuffers.push_back(allocator.createBufferAndUploadData(
-                command,
-                primitive.vertices,
-                vk::BufferUsageFlagBits2::eVertexBuffer));
+        if (!commands.empty()) {
+            // also read as a storage buffer by the cull pass
+            indirectCommandsBuffer = allocator.createBufferAndUploadData(
+                uploads,
+                commands,
+                vk::BufferUsageFlagBits2::eIndirectBuffer
+                    | vk::BufferUsageFlagBits2::eStorageBuffer);
 
-            indexBuffers.push_back(allocator.createBufferAndUploadData(
-                command,
-                primitive.indices,
-                vk::BufferUsageFlagBits2::eIndexBuffer));
+            drawBoundsSSBO = allocator.createBufferAndUploadData(
+                uploads,
+                drawBounds,
+                vk::BufferUsageFlagBits2::eStorageBuffer);
+        }
+
+        // the binding must stay valid even without draws
+        if (drawData.empty()) {
+            drawData.push_back(DrawData{});
+        }
+
+        drawDataSSBO = allocator.createBufferAndUploadData(
+            uploads,
+            drawData,
+            vk::BufferUsageFlagBits2::eStorageBuffer);
+    }
+
+    // counting sort of the draws by node instance
+    instanceDrawOffsets.assign(sceneView.nodeInstances.size() + 1u, 0u);
+
+    for (const DrawItem &draw : draws) {
+        ++instanceDrawOffsets[draw.nodeInstanceIndex + 1u];
+    }
+
+    for (std::size_t instance = 1u; instance < instanceDrawOffsets.size(); ++instance) {
+        instanceDrawOffsets[instance] += instanceDrawOffsets[instance - 1u];
+    }
+
+    instanceDraws.resize(draws.size());
+
+    {
+        std::vector<std::uint32_t> cursors(
+            instanceDrawOffsets.begin(),
+            instanceDrawOffsets.end() - 1);
+
+        for (const auto &[drawIndex, draw] : std::views::enumerate(draws)) {
+            instanceDraws[cursors[draw.nodeInstanceIndex]++] =
+                static_cast<std::uint32_t>(drawIndex);
         }
     }
 
@@ -123,22 +486,55 @@ auto RenderableResources::create(
     }
 
     materialsSSBO = allocator.createBufferAndUploadData(
-        command,
+        uploads,
         packedMaterials,
         vk::BufferUsageFlagBits2::eStorageBuffer);
 
-    for (const Texture &texture : asset.textures) {
+    // images filled by host image copy below; the rest go through uploads
+    std::vector<std::size_t> hostCopiedImages{};
+
+    // what each GPU image is created from: the asset image, or the
+    // placeholder when its format cannot be sampled
+    std::vector<const TextureImage *> sourceImages{};
+    sourceImages.reserve(asset.images.size());
+
+    for (const auto &[imageIndex, assetImage] : std::views::enumerate(asset.images)) {
+
+        // Block-compressed formats are optional (textureCompressionBC). The
+        // loader only produces formats in AssetLoadOptions::textureFormats,
+        // so this only catches assets loaded for another device.
+        const vk::FormatFeatureFlags features =
+            device.physicalDevice.handle.getFormatProperties(assetImage.format)
+                .optimalTilingFeatures;
+
+        const bool sampleable =
+            static_cast<bool>(features & vk::FormatFeatureFlagBits::eSampledImage);
+
+        if (!sampleable) {
+            fmt::println(
+                stderr,
+                "image {}: {} cannot be sampled on this device, using a placeholder",
+                imageIndex,
+                vk::to_string(assetImage.format));
+        }
+
+        const TextureImage &textureImage = sampleable ? assetImage : placeholderImage();
 
-        const vk::Extent3D extent3D{texture.extent.width, texture.extent.height, 1u};
+        sourceImages.push_back(&textureImage);
+
+        const vk::Extent3D extent3D{
+            textureImage.extent.width,
+            textureImage.extent.height,
+            1u};
 
         vk::ImageCreateInfo imageInfo{};
         imageInfo.flags = vk::ImageCreateFlagBits::eMutableFormat;
 
         imageInfo.imageType = vk::ImageType::e2D;
-        imageInfo.format    = vk::Format::eR8G8B8A8Unorm;
+        imageInfo.format    = textureImage.format;
 
         imageInfo.extent      = extent3D;
-        imageInfo.mipLevels   = 1u;
+        imageInfo.mipLevels   = textureImage.mipLevels;
         imageInfo.arrayLayers = 1u;
 
         imageInfo.samples = vk::SampleCountFlagBits::e1;
@@ -146,19 +542,24 @@ auto RenderableResources::create(
 
         imageInfo.usage = vk::ImageUsageFlagBits::eSampled;
 
-        Image image = allocator.createImageAndUploadData(
-            command,
-            texture.rgba8,
-            imageInfo,
-            vk::ImageLayout::eShaderReadOnlyOptimal);
-
-        textureImages.push_back(image);
+        if (hostImageCopy.supports(imageInfo)) {
+            imageInfo.usage |= vk::ImageUsageFlagBits::eHostTransfer;
+
+            textureImages.push_back(allocator.createImage(imageInfo));
+            hostCopiedImages.push_back(static_cast<std::size_t>(imageIndex));
+        } else {
+            textureImages.push_back(allocator.createImageAndUploadData(
+                uploads,
+                textureImage.bytes(),
+                imageInfo,
+                vk::ImageLayout::eShaderReadOnlyOptimal));
+        }
 
         vk::ImageSubresourceRange range{};
         range.aspectMask = vk::ImageAspectFlagBits::eColor;
 
         range.baseMipLevel   = 0u;
-        range.levelCount     = 1u;
+        range.levelCount     = textureImage.mipLevels;
         range.baseArrayLayer = 0u;
         range.layerCount     = 1u;
 
@@ -167,7 +568,7 @@ auto RenderableResources::create(
                 {},
                 textureImages.back().image,
                 vk::ImageViewType::e2D,
-                vk::Format::eR8G8B8A8Srgb,
+                srgbViewFormat(textureImage.format),
                 {},
                 range}));
 
@@ -176,15 +577,27 @@ auto RenderableResources::create(
                 {},
                 textureImages.back().image,
                 vk::ImageViewType::e2D,
-                vk::Format::eR8G8B8A8Unorm,
+                textureImage.format,
                 {},
                 range}));
     }
 
-    command.endSingleTime(device);
+    // Host copies are synchronous and touch no command buffer, so they run
+    // on the worker pool, one image per task.
+    parallelFor(hostCopiedImages.size(), [&](std::size_t slot) {
+        const std::size_t imageIndex = hostCopiedImages[slot];
+
+        hostImageCopy.upload(textureImages[imageIndex].image, *sourceImages[imageIndex]);
+    });
+
+    // the renderer acquires these resources in its next frame; nothing
+    // waits on the CPU
+    uploads.submit();
 
     for (const auto &[textureIndex, texture] : std::views::enumerate(asset.textures)) {
 
+        textureImageIndices.push_back(texture.imageIndex);
+
         const std::uint32_t uniqueSamplerIndex = getOrCreateSamplerIndex(
             device,
             texture.samplerInfo,
@@ -195,6 +608,34 @@ auto RenderableResources::create(
     }
 }
 
+void RenderableResources::updateWorldBounds(
+    std::span<const NodeInstanceData> instances,
+    std::span<const std::uint32_t>    changedInstances)
+{
+    for (const std::uint32_t instance : changedInstances) {
+        if (instance + 1u >= instanceDrawOffsets.size()) {
+            continue;
+        }
+
+        const glm::mat4 &modelMatrix = instances[instance].modelMatrix;
+
+        for (std::uint32_t slot = instanceDrawOffsets[instance];
+             slot < instanceDrawOffsets[instance + 1u];
+             ++slot) {
+            const std::uint32_t drawIndex = instanceDraws[slot];
+
+            const AABB worldAABB =
+                computeWorldAABBFromLocalAABB(localDrawBounds[drawIndex], modelMatrix);
+
+            worldDrawBounds.set(drawIndex, worldAABB);
+
+            drawSortInfos[drawIndex].worldCenter =
+                worldAABB.isValid() ? 0.5f * (worldAABB.min + worldAABB.max)
+                                    : glm::vec3{0.0f};
+        }
+    }
+}
+
 void RenderableResources::updateDescriptorSet(
     Device           &device,
     vk::DescriptorSet descriptorSet,
@@ -246,14 +687,32 @@ void RenderableResources::updateDescriptorSet(
             materialsBufferInfo,
         });
 
+    const auto drawDataBufferInfo = vk::DescriptorBufferInfo{
+        drawDataSSBO.buffer,
+        0,
+        vk::WholeSize,
+    };
+
+    descriptorWrites.emplace_back(
+        vk::WriteDescriptorSet{
+            descriptorSet,
+            kBindingDrawData,
+            0,
+            vk::DescriptorType::eStorageBuffer,
+            {},
+            drawDataBufferInfo,
+        });
+
+    // descriptor arrays stay indexed by texture; textures sharing an image
+    // reference the same views
     std::vector<vk::DescriptorImageInfo> srgbTextureImageViewInfos;
-    srgbTextureImageViewInfos.reserve(srgbTextureImageViews.size());
+    srgbTextureImageViewInfos.reserve(textureImageIndices.size());
 
-    for (const auto &srgbView : srgbTextureImageViews) {
+    for (const std::uint32_t imageIndex : textureImageIndices) {
         srgbTextureImageViewInfos.emplace_back(
             vk::DescriptorImageInfo{
                 vk::Sampler{},
-                *srgbView,
+                *srgbTextureImageViews[imageIndex],
                 vk::ImageLayout::eShaderReadOnlyOptimal,
             });
     }
@@ -268,13 +727,13 @@ void RenderableResources::updateDescriptorSet(
         });
 
     std::vector<vk::DescriptorImageInfo> linearTextureImageViewInfos;
-    linearTextureImageViewInfos.reserve(linearTextureImageViews.size());
+    linearTextureImageViewInfos.reserve(textureImageIndices.size());
 
-    for (const auto &linearView : linearTextureImageViews) {
+    for (const std::uint32_t imageIndex : textureImageIndices) {
         linearTextureImageViewInfos.emplace_back(
             vk::DescriptorImageInfo{
                 vk::Sampler{},
-                *linearView,
+                *linearTextureImageViews[imageIndex],
                 vk::ImageLayout::eShaderReadOnlyOptimal,
             });
     }
@@ -311,3 +770,58 @@ void RenderableResources::updateDescriptorSet(
 
     device.handle.updateDescriptorSets(descriptorWrites, {});
 }
+
+void RenderableResources::updateDescriptorBuffer(
+    DescriptorBuffer &descriptorBuffer,
+    uint32_t          frameIndex,
+    const Buffer     &frameUBO,
+    const Buffer     &nodeInstancesSSBO) const
+{
+    descriptorBuffer.writeBuffer(
+        frameIndex,
+        kBindingFrameUniforms,
+        vk::DescriptorType::eUniformBuffer,
+        frameUBO.buffer,
+        sizeof(FrameUniforms));
+
+    descriptorBuffer.writeBuffer(
+        frameIndex,
+        kBindingNodeInstanceData,
+        vk::DescriptorType::eStorageBuffer,
+        nodeInstancesSSBO.buffer,
+        nodeInstancesSSBO.size);
+
+    descriptorBuffer.writeBuffer(
+        frameIndex,
+        kBindingMaterialData,
+        vk::DescriptorType::eStorageBuffer,
+        materialsSSBO.buffer,
+        materialsSSBO.size);
+
+    descriptorBuffer.writeBuffer(
+        frameIndex,
+        kBindingDrawData,
+        vk::DescriptorType::eStorageBuffer,
+        drawDataSSBO.buffer,
+        drawDataSSBO.size);
+
+    // indexed by texture, like updateDescriptorSet
+    std::vector<vk::ImageView> imageViews;
+    imageViews.reserve(textureImageIndices.size());
+
+    for (const std::uint32_t imageIndex : textureImageIndices) {
+        imageViews.push_back(*srgbTextureImageViews[imageIndex]);
+    }
+
+    descriptorBuffer.writeSampledImages(frameIndex, kBindingImagesSrgb, imageViews);
+
+    imageViews.clear();
+
+    for (const std::uint32_t imageIndex : textureImageIndices) {
+        imageViews.push_back(*linearTextureImageViews[imageIndex]);
+    }
+
+    descriptorBuffer.writeSampledImages(frameIndex, kBindingImagesLinear, imageViews);
+
+    descriptorBuffer.writeSamplers(frameIndex, kBindingSamplers, samplerHandles);
+}
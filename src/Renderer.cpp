@@ -5,6 +5,11 @@
 #include "RenderableResources.hpp"
 #include "ShaderInterfaceTypes.hpp"
 
+#include <algorithm>
+#include <numeric>
+
+#include <fmt/base.h>
+
 auto Renderer::createDescriptorPool(
     Device                           &device,
     const ShaderInterfaceDescription &shaderInterfaceDescription,
@@ -31,7 +36,14 @@ auto Renderer::createDescriptorPool(
 
 auto Renderer::allocateFrameDescriptorSets() -> void
 {
+    describedSources.assign(frames.maxFrames(), DescriptorSources{});
+
     frames.descriptorSets.clear();
+
+    if (useDescriptorBuffer) {
+        return;
+    }
+
     frames.descriptorSets.reserve(frames.descriptorSets.capacity());
 
     auto layouts = std::vector<vk::DescriptorSetLayout>(
@@ -53,31 +65,136 @@ auto Renderer::initializePerFrameUniformBuffers(
     frames.initializePerFrameUniformBuffers(allocator, nodeInstancesCount);
 }
 
+auto Renderer::initializePerFrameCullBuffers(
+    Allocator &allocator,
+    uint32_t   drawCount) -> void
+{
+    if (cullPass) {
+        cullPass->initializePerFrameBuffers(allocator, drawCount);
+    }
+}
+
 Renderer::Renderer(
     RenderContext        &context_,
     const RendererConfig &config)
     : context{context_},
+      useDescriptorBuffer{
+          config.descriptorBuffer
+          && DescriptorBuffer::supported(
+              context.physicalDevice,
+              context.device)},
       shaderInterface{
-          context.device,
-          config.shaderInterfaceDescription},
-      descriptorPool{createDescriptorPool(
           context.device,
           config.shaderInterfaceDescription,
-          config.maxFramesInFlight)},
+          useDescriptorBuffer ? vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT
+                              : vk::DescriptorSetLayoutCreateFlags{}},
+      descriptorPool{
+          useDescriptorBuffer ? vk::raii::DescriptorPool{nullptr}
+                              : createDescriptorPool(
+                                    context.device,
+                                    config.shaderInterfaceDescription,
+                                    config.maxFramesInFlight)},
       pipelineLayout{createPipelineLayout(
           context.device.handle,
           {*shaderInterface.handle})},
       graphicsPipeline{createPipeline(
           context.device,
+          context.pipelineCache,
           config.shaderPath,
           config.colorFormat,
           config.depthFormat,
-          pipelineLayout)},
+          pipelineLayout,
+          useDescriptorBuffer ? vk::PipelineCreateFlagBits::eDescriptorBufferEXT
+                              : vk::PipelineCreateFlags{})},
       frames{
           context.device,
-          config.maxFramesInFlight}
+          config.maxFramesInFlight},
+      drawSubmission{config.drawSubmission}
 {
+    if (config.descriptorBuffer && !useDescriptorBuffer) {
+        fmt::println(stderr, "descriptor buffers unsupported, using descriptor sets");
+    }
+
+    if (useDescriptorBuffer) {
+        descriptorBuffer.emplace(
+            context.physicalDevice,
+            context.device,
+            context.allocator,
+            shaderInterface.handle,
+            config.shaderInterfaceDescription,
+            config.maxFramesInFlight);
+    }
+
     allocateFrameDescriptorSets();
+
+    frames.initializeTransientRing(
+        context.device,
+        context.allocator,
+        config.transientRingBytes);
+
+    const auto featureChain = context.physicalDevice.handle.getFeatures2<
+        vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDeviceVulkan12Features>();
+
+    const auto &features = featureChain.get<vk::PhysicalDeviceFeatures2>().features;
+    const auto &vulkan12Features =
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>();
+
+    const auto limits = context.physicalDevice.handle.getProperties().limits;
+
+    if (features.multiDrawIndirect) {
+        maxIndirectDrawsPerCall = std::max(limits.maxDrawIndirectCount, 1u);
+    }
+
+    // DrawData is indexed by firstInstance
+    if (drawSubmission == DrawSubmission::Indirect
+        && !features.drawIndirectFirstInstance) {
+        fmt::println(
+            stderr,
+            "drawIndirectFirstInstance unsupported, using direct draws");
+        drawSubmission = DrawSubmission::Direct;
+    }
+
+    // Without count draws the cull pass cannot compact commands, and
+    // indirect submission would draw everything; direct submission keeps
+    // culling on the CPU instead.
+    const bool gpuCullingSupported =
+        vulkan12Features.drawIndirectCount && features.multiDrawIndirect;
+
+    bool cpuCullingFallback = false;
+
+    if (config.gpuFrustumCulling && drawSubmission == DrawSubmission::Indirect
+        && !gpuCullingSupported) {
+        fmt::println(
+            stderr,
+            "drawIndirectCount/multiDrawIndirect unsupported, using direct draws "
+            "with CPU culling");
+        drawSubmission     = DrawSubmission::Direct;
+        cpuCullingFallback = true;
+    }
+
+    cpuFrustumCulling = (config.cpuFrustumCulling || cpuCullingFallback)
+                     && drawSubmission == DrawSubmission::Direct;
+
+    drawSorting = config.drawSorting;
+
+    if (config.gpuFrustumCulling && drawSubmission == DrawSubmission::Indirect) {
+        cullPass.emplace(
+            context.device,
+            context.pipelineCache,
+            config.cullShaderPath,
+            config.maxFramesInFlight,
+            config.gpuOcclusionCulling);
+
+        if (config.gpuOcclusionCulling) {
+            context.renderTargets.enableDepthPyramid(context.device);
+
+            depthPyramidPass.emplace(
+                context.device,
+                context.pipelineCache,
+                config.depthPyramidShaderPath);
+        }
+    }
 }
 
 auto Renderer::beginFrame() -> bool
@@ -99,6 +216,10 @@ auto Renderer::beginFrame() -> bool
         vk::SemaphoreWaitInfo{{}, timelineSemaphore, timelineValue},
         std::numeric_limits<uint64_t>::max());
 
+    // every frame up to this slot's last submission has finished
+    frames.transientRing->reclaim(timelineValue);
+    context.uploadQueue.collect();
+
     frames.cmdPool().reset();
     frames.cmd().begin({});
 
@@ -116,10 +237,222 @@ auto Renderer::beginFrame() -> bool
         return false;
     }
 
+    // take ownership of finished async uploads; only once the frame is known
+    // to be submitted, or the barriers would be lost with the reset
+    uploadWait = context.uploadQueue.recordAcquires(frames.cmd());
+
     return true;
 }
 
+auto Renderer::cullDraws(
+    const RenderableResources &renderableResources,
+    const glm::mat4           &viewProjection) -> CullStats
+{
+    if (!cpuFrustumCulling) {
+        return CullStats{};
+    }
+
+    return FrustumCuller::cull(
+        Frustum::fromViewProjection(viewProjection),
+        renderableResources.worldDrawBounds,
+        visibleDrawIndices);
+}
+
+auto Renderer::sortDraws(
+    const RenderableResources &renderableResources,
+    const glm::mat4           &viewMatrix) -> void
+{
+    if (!drawSorting) {
+        return;
+    }
+
+    // opaque indirect draws keep their groups (and their GPU culled order);
+    // only the blended tail needs an order
+    if (drawSubmission == DrawSubmission::Indirect) {
+        const auto drawCount = static_cast<uint32_t>(renderableResources.draws.size());
+
+        blendedDrawIndices.resize(drawCount - renderableResources.firstBlendedDraw);
+        std::iota(
+            blendedDrawIndices.begin(),
+            blendedDrawIndices.end(),
+            renderableResources.firstBlendedDraw);
+
+        renderQueue.build(
+            renderableResources.drawSortInfos,
+            blendedDrawIndices,
+            viewMatrix);
+
+        return;
+    }
+
+    if (cpuFrustumCulling) {
+        renderQueue.build(
+            renderableResources.drawSortInfos,
+            visibleDrawIndices,
+            viewMatrix);
+    } else {
+        renderQueue.buildAll(renderableResources.drawSortInfos, viewMatrix);
+    }
+}
+
+auto Renderer::descriptorSources(const RenderableResources &renderableResources) const
+    -> DescriptorSources
+{
+    return DescriptorSources{
+        .resources      = renderableResources.generation,
+        .uniformBuffers = frames.uniformBuffersGeneration,
+        .renderTargets  = context.renderTargets.generation,
+    };
+}
+
+auto Renderer::updateDescriptorSet(const RenderableResources &renderableResources)
+    -> void
+{
+    // the base pass set does not reference render targets
+    auto sources          = descriptorSources(renderableResources);
+    sources.renderTargets = 0u;
+
+    auto &described = describedSources[frames.current()];
+
+    if (described == sources) {
+        return;
+    }
+
+    // beginFrame() waited for this slot, so its set is no longer in use
+    if (descriptorBuffer) {
+        renderableResources.updateDescriptorBuffer(
+            *descriptorBuffer,
+            frames.current(),
+            frames.frameUBO[frames.current()],
+            frames.nodeInstancesSSBO[frames.current()]);
+
+        descriptorBuffer->flush(frames.current());
+    } else {
+        renderableResources.updateDescriptorSet(
+            context.device,
+            frames.currentDescriptorSet(),
+            frames.frameUBO[frames.current()],
+            frames.nodeInstancesSSBO[frames.current()]);
+    }
+
+    described = sources;
+}
+
 auto Renderer::render(const RenderableResources &renderableResources) -> void
+{
+    auto &depth        = context.renderTargets.mainDepth;
+    auto &depthPyramid = context.renderTargets.mainDepthPyramid;
+
+    const bool cullOnGpu = cullPass && drawSubmission == DrawSubmission::Indirect
+                        && renderableResources.indirectDrawCount > 0u;
+
+    const bool cullOcclusion = cullOnGpu && depthPyramidPass;
+
+    // compute work must be recorded outside the rendering scope
+    if (cullOnGpu) {
+        cullPass->updateDescriptorSet(
+            context.device,
+            frames.current(),
+            frames.frameUBO[frames.current()],
+            frames.nodeInstancesSSBO[frames.current()],
+            renderableResources,
+            cullOcclusion ? *depthPyramid.view : vk::ImageView{},
+            descriptorSources(renderableResources));
+
+        // blended draws are never culled on the GPU: the cull lists only
+        // cover the opaque draws in front of them
+        cullPass->record(
+            frames.cmd(),
+            frames.current(),
+            renderableResources.firstBlendedDraw,
+            cullOcclusion ? CullPhase::Early : CullPhase::Frustum,
+            depthPyramid);
+    }
+
+    imageLayoutState.transition(
+        frames.cmd(),
+        context.swapchain.nextImage(),
+        vk::ImageSubresourceRange{
+            vk::ImageAspectFlagBits::eColor,
+            0,
+            1,
+            0,
+            1,
+        },
+        ImageUse::kColorAttachmentWrite);
+
+    imageLayoutState.transition(
+        frames.cmd(),
+        depth.image.get(),
+        depth.range(),
+        ImageUse::kDepthAttachmentWrite);
+
+    // the pyramid is built from the early pass depth
+    const auto depthStoreOp = cullOcclusion ? vk::AttachmentStoreOp::eStore
+                                            : vk::AttachmentStoreOp::eDontCare;
+
+    // with occlusion culling, opaque draws only found visible by the late
+    // pass could still cover blended surfaces; those wait for the late pass
+    recordBasePass(
+        renderableResources,
+        vk::AttachmentLoadOp::eClear,
+        depthStoreOp,
+        CullList::Main,
+        !cullOcclusion);
+
+    if (!cullOcclusion) {
+        return;
+    }
+
+    // Hi-Z pyramid from the early pass depth
+    depthPyramidPass->updateDescriptorSets(
+        context.device,
+        depth,
+        depthPyramid,
+        context.renderTargets.generation);
+
+    imageLayoutState.transition(
+        frames.cmd(),
+        depth.image.get(),
+        depth.range(),
+        ImageUse::kShaderSampledRead);
+
+    imageLayoutState.transition(
+        frames.cmd(),
+        depthPyramid.image.get(),
+        depthPyramid.range(),
+        ImageUse::kComputeStorageReadWrite);
+
+    depthPyramidPass->record(frames.cmd(), depth, depthPyramid);
+
+    cullPass->record(
+        frames.cmd(),
+        frames.current(),
+        renderableResources.firstBlendedDraw,
+        CullPhase::Late,
+        depthPyramid);
+
+    imageLayoutState.transition(
+        frames.cmd(),
+        depth.image.get(),
+        depth.range(),
+        ImageUse::kDepthAttachmentWrite);
+
+    // newly visible draws on top of the early pass, then every blended draw
+    recordBasePass(
+        renderableResources,
+        vk::AttachmentLoadOp::eLoad,
+        vk::AttachmentStoreOp::eDontCare,
+        CullList::Late,
+        true);
+}
+
+auto Renderer::recordBasePass(
+    const RenderableResources &renderableResources,
+    vk::AttachmentLoadOp       loadOp,
+    vk::AttachmentStoreOp      depthStoreOp,
+    CullList                   cullList,
+    bool                       drawBlended) -> void
 {
     auto renderingColorAttachmentInfo = vk::RenderingAttachmentInfo{
         context.swapchain.nextImageView(),
@@ -127,23 +460,21 @@ auto Renderer::render(const RenderableResources &renderableResources) -> void
         {},
         {},
         {},
-        vk::AttachmentLoadOp::eClear,
+        loadOp,
         vk::AttachmentStoreOp::eStore,
         vk::ClearColorValue{
             std::array{0.2f, 0.5f, 1.0f, 1.0f},
         },
     };
 
-    auto &depth = context.renderTargets.mainDepth;
-
     auto renderingDepthAttachmentInfo = vk::RenderingAttachmentInfo{
-        depth.view,
+        context.renderTargets.mainDepth.view,
         vk::ImageLayout::eDepthAttachmentOptimal,
         {},
         {},
         {},
-        vk::AttachmentLoadOp::eClear,
-        vk::AttachmentStoreOp::eDontCare,
+        loadOp,
+        depthStoreOp,
         vk::ClearDepthStencilValue{1.0f, 0},
     };
 
@@ -156,24 +487,6 @@ auto Renderer::render(const RenderableResources &renderableResources) -> void
         &renderingDepthAttachmentInfo,
     };
 
-    imageLayoutState.transition(
-        frames.cmd(),
-        context.swapchain.nextImage(),
-        vk::ImageSubresourceRange{
-            vk::ImageAspectFlagBits::eColor,
-            0,
-            1,
-            0,
-            1,
-        },
-        ImageUse::kColorAttachmentWrite);
-
-    imageLayoutState.transition(
-        frames.cmd(),
-        depth.image.get(),
-        depth.range(),
-        ImageUse::kDepthAttachmentWrite);
-
     frames.cmd().beginRendering(renderingInfo);
     frames.cmd().setViewportWithCount(
         vk::Viewport(
@@ -196,29 +509,61 @@ auto Renderer::render(const RenderableResources &renderableResources) -> void
     frames.cmd().bindPipeline(vk::PipelineBindPoint::eGraphics, *graphicsPipeline);
 
     // bind texture resources passed to shader
-    frames.cmd().bindDescriptorSets(
-        vk::PipelineBindPoint::eGraphics,
-        *pipelineLayout,
-        0,
-        frames.currentDescriptorSet(),
-        {});
+    if (descriptorBuffer) {
+        descriptorBuffer->bind(
+            frames.cmd(),
+            vk::PipelineBindPoint::eGraphics,
+            *pipelineLayout,
+            frames.current());
+    } else {
+        frames.cmd().bindDescriptorSets(
+            vk::PipelineBindPoint::eGraphics,
+            *pipelineLayout,
+            0,
+            frames.currentDescriptorSet(),
+            {});
+    }
 
-    for (const auto &draw : renderableResources.draws) {
+    // all geometry lives in one vertex/index buffer pair; draws select their
+    // range with firstIndex/vertexOffset, and the index buffer section of
+    // their index type is bound when it changes
+    if (!renderableResources.draws.empty()) {
+        frames.cmd().bindVertexBuffers(0, renderableResources.vertexBuffer.buffer, {0});
 
-        frames.cmd().bindVertexBuffers(
-            0,
-            renderableResources.vertexBuffers[draw.geometryIndex].buffer,
-            {0});
+        boundIndexType.reset();
 
-        frames.cmd().bindIndexBuffer(
-            renderableResources.indexBuffers[draw.geometryIndex].buffer,
-            0,
-            vk::IndexType::eUint32);
+        if (drawSubmission == DrawSubmission::Indirect) {
+            recordIndirectDraws(renderableResources, cullList, drawBlended);
+        } else {
+            recordDirectDraws(renderableResources);
+        }
+    }
+
+    frames.cmd().endRendering();
+}
+
+auto Renderer::recordDirectDraws(const RenderableResources &renderableResources)
+    -> void
+{
+    // state changes only where consecutive draws differ
+    std::optional<RasterState> currentState;
+
+    const auto recordDraw = [&](uint32_t drawIndex) {
+        const DrawItem    &draw  = renderableResources.draws[drawIndex];
+        const RasterState &state = renderableResources.drawRasterStates[drawIndex];
+
+        if (currentState != state) {
+            setRasterState(frames.cmd(), state);
+            currentState = state;
+        }
+
+        bindIndexBuffer(renderableResources, draw.indexType);
 
         auto pushConstant = PushConstants{
             .nodeInstanceIndex = draw.nodeInstanceIndex,
             .materialIndex     = draw.materialIndex,
-            .debugView         = static_cast<uint32_t>(debugView)};
+            .debugView         = static_cast<uint32_t>(debugView),
+            .uvEncoding        = draw.uvEncoding};
 
         frames.cmd().pushConstants2(
             vk::PushConstantsInfo{
@@ -230,9 +575,175 @@ auto Renderer::render(const RenderableResources &renderableResources) -> void
 
         frames.cmd()
             .drawIndexed(draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
+    };
+
+    if (drawSorting) {
+        for (const uint32_t drawIndex : renderQueue.drawIndices()) {
+            recordDraw(drawIndex);
+        }
+
+        return;
     }
 
-    frames.cmd().endRendering();
+    if (cpuFrustumCulling) {
+        for (const uint32_t drawIndex : visibleDrawIndices) {
+            recordDraw(drawIndex);
+        }
+
+        return;
+    }
+
+    const auto drawCount = static_cast<uint32_t>(renderableResources.draws.size());
+
+    for (uint32_t drawIndex = 0u; drawIndex < drawCount; ++drawIndex) {
+        recordDraw(drawIndex);
+    }
+}
+
+auto Renderer::bindIndexBuffer(
+    const RenderableResources &renderableResources,
+    vk::IndexType              indexType) -> void
+{
+    if (boundIndexType == indexType) {
+        return;
+    }
+
+    frames.cmd().bindIndexBuffer(
+        renderableResources.indexBuffer.buffer,
+        renderableResources.indexBufferOffset(indexType),
+        indexType);
+
+    boundIndexType = indexType;
+}
+
+auto Renderer::recordIndirectDraws(
+    const RenderableResources &renderableResources,
+    CullList                   cullList,
+    bool                       drawBlended) -> void
+{
+    // one push for the whole pass; per-draw indices come from DrawData
+    auto pushConstant = PushConstants{
+        .debugView   = static_cast<uint32_t>(debugView),
+        .useDrawData = 1u,
+    };
+
+    frames.cmd().pushConstants2(
+        vk::PushConstantsInfo{
+            *pipelineLayout,
+            vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+            0,
+            sizeof(PushConstants),
+            &pushConstant});
+
+    constexpr auto stride =
+        static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+
+    // draws are ordered by raster state: one state change per group
+    for (const RasterStateGroup &group : renderableResources.rasterStateGroups) {
+        // sorted blended draws cross group boundaries; recorded below
+        if (group.state.blendEnable && (!drawBlended || drawSorting)) {
+            continue;
+        }
+
+        setRasterState(frames.cmd(), group.state);
+        bindIndexBuffer(renderableResources, group.indexType);
+
+        if (cullPass && !group.state.blendEnable) {
+            // visible commands and their count were written by the cull pass,
+            // in the group's section of each buffer
+            frames.cmd().drawIndexedIndirectCount(
+                cullPass->visibleCommands(frames.current(), cullList).buffer,
+                static_cast<vk::DeviceSize>(group.firstDraw) * stride,
+                cullPass->visibleCount(frames.current(), cullList).buffer,
+                static_cast<vk::DeviceSize>(group.firstDraw) * sizeof(uint32_t),
+                group.drawCount,
+                stride);
+
+            continue;
+        }
+
+        const uint32_t groupEnd = group.firstDraw + group.drawCount;
+
+        for (uint32_t firstDraw = group.firstDraw; firstDraw < groupEnd;
+             firstDraw += maxIndirectDrawsPerCall) {
+
+            const uint32_t batchCount =
+                std::min(maxIndirectDrawsPerCall, groupEnd - firstDraw);
+
+            frames.cmd().drawIndexedIndirect(
+                renderableResources.indirectCommandsBuffer.buffer,
+                static_cast<vk::DeviceSize>(firstDraw) * stride,
+                batchCount,
+                stride);
+        }
+    }
+
+    if (drawBlended && drawSorting) {
+        recordSortedBlendedDraws(renderableResources);
+    }
+}
+
+auto Renderer::recordSortedBlendedDraws(
+    const RenderableResources &renderableResources) -> void
+{
+    const auto order = renderQueue.drawIndices();
+
+    if (order.empty()) {
+        return;
+    }
+
+    sortedBlendedCommands.clear();
+
+    for (const uint32_t drawIndex : order) {
+        const DrawItem &draw = renderableResources.draws[drawIndex];
+
+        sortedBlendedCommands.push_back(
+            vk::DrawIndexedIndirectCommand{
+                draw.indexCount,
+                1u,
+                draw.firstIndex,
+                draw.vertexOffset,
+                drawIndex,
+            });
+    }
+
+    const TransientAllocation commands = frames.transientRing->upload(
+        std::span<const vk::DrawIndexedIndirectCommand>{sortedBlendedCommands},
+        alignof(vk::DrawIndexedIndirectCommand));
+
+    constexpr auto stride =
+        static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+
+    const auto sameBatch = [&](uint32_t a, uint32_t b) {
+        return renderableResources.drawRasterStates[a]
+                == renderableResources.drawRasterStates[b]
+            && renderableResources.draws[a].indexType
+                   == renderableResources.draws[b].indexType;
+    };
+
+    const auto count = static_cast<uint32_t>(order.size());
+
+    for (uint32_t first = 0u; first < count;) {
+        uint32_t end = first + 1u;
+
+        while (end < count && end - first < maxIndirectDrawsPerCall
+               && sameBatch(order[first], order[end])) {
+            ++end;
+        }
+
+        const uint32_t drawIndex = order[first];
+
+        setRasterState(frames.cmd(), renderableResources.drawRasterStates[drawIndex]);
+        bindIndexBuffer(renderableResources, renderableResources.draws[drawIndex].indexType);
+
+        frames.cmd().drawIndexedIndirect(
+            commands.buffer,
+            commands.offset + static_cast<vk::DeviceSize>(first) * stride,
+            end - first,
+            stride);
+
+        first = end;
+    }
 }
 
 auto Renderer::submit() -> void
@@ -253,10 +764,18 @@ auto Renderer::submit() -> void
     uint64_t signalFrameValue = frames.timelineValue() + frames.maxFrames();
     frames.timelineValue()    = signalFrameValue;
 
-    auto waitSemaphoreSubmitInfo = vk::SemaphoreSubmitInfo{
-        frames.imageAvailableSemaphore(),
-        {},
-        vk::PipelineStageFlagBits2::eAllCommands};
+    frames.transientRing->closeFrame(signalFrameValue);
+
+    auto waitSemaphoreSubmitInfos = std::vector{
+        vk::SemaphoreSubmitInfo{
+            frames.imageAvailableSemaphore(),
+            {},
+            vk::PipelineStageFlagBits2::eAllCommands}};
+
+    if (uploadWait) {
+        waitSemaphoreSubmitInfos.push_back(*uploadWait);
+        uploadWait.reset();
+    }
 
     auto signalSemaphoreSubmitInfos = std::array{
         vk::SemaphoreSubmitInfo{
@@ -273,7 +792,7 @@ auto Renderer::submit() -> void
     context.device.graphicsQueue.submit2(
         vk::SubmitInfo2{
             {},
-            waitSemaphoreSubmitInfo,
+            waitSemaphoreSubmitInfos,
             commandBufferSubmitInfo,
             signalSemaphoreSubmitInfos});
 }
@@ -316,6 +835,21 @@ Buffer &Renderer::currentNodeInstancesSSBO()
     return frames.nodeInstancesSSBO[frames.current()];
 }
 
+uint32_t Renderer::currentFrameIndex() const
+{
+    return frames.current();
+}
+
+TransientRing &Renderer::transientRing()
+{
+    return *frames.transientRing;
+}
+
+uint64_t Renderer::uniformBuffersGeneration() const
+{
+    return frames.uniformBuffersGeneration;
+}
+
 void Renderer::cycleDebugView()
 {
     switch (debugView) {
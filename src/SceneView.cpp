@@ -164,14 +164,16 @@ auto visitNode(
 
             sceneView.draws.push_back(
                 DrawItem{
-                    .indexCount    = static_cast<std::uint32_t>(submesh.indices.size()),
+                    .indexCount    = static_cast<std::uint32_t>(submesh.indexCount()),
                     .firstIndex    = 0u,
                     .vertexOffset  = 0,
+                    .indexType     = submeshIndexType(submesh),
                     .meshIndex     = meshIndex,
                     .submeshIndex  = static_cast<std::uint32_t>(submeshIndex),
                     .geometryIndex = 0u,
                     .nodeInstanceIndex = nodeInstanceIndex,
                     .materialIndex     = submesh.materialIndex,
+                    .uvEncoding        = submesh.uvEncoding,
                 });
         }
     }
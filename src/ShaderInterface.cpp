@@ -6,17 +6,20 @@
 #include <vector>
 
 ShaderInterface::ShaderInterface(
-    Device                           &device,
-    const ShaderInterfaceDescription &description)
+    Device                             &device,
+    const ShaderInterfaceDescription   &description,
+    vk::DescriptorSetLayoutCreateFlags flags)
     : handle{create(
           device,
-          description)}
+          description,
+          flags)}
 {
 }
 
 auto ShaderInterface::create(
-    Device                           &device,
-    const ShaderInterfaceDescription &description) -> vk::raii::DescriptorSetLayout
+    Device                             &device,
+    const ShaderInterfaceDescription   &description,
+    vk::DescriptorSetLayoutCreateFlags flags) -> vk::raii::DescriptorSetLayout
 {
     std::vector<vk::DescriptorSetLayoutBinding> bindings;
     bindings.reserve(description.bindings.size());
@@ -25,7 +28,7 @@ auto ShaderInterface::create(
         bindings.emplace_back(b.binding, b.type, b.count, b.stages);
     }
 
-    return {device.handle, vk::DescriptorSetLayoutCreateInfo{{}, bindings}};
+    return {device.handle, vk::DescriptorSetLayoutCreateInfo{flags, bindings}};
 }
 
 // ShaderInterface::ShaderInterface(
@@ -0,0 +1,132 @@
+#include "TransientRing.hpp"
+
+#include "Utility.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+
+[[nodiscard]]
+auto alignUp(
+    vk::DeviceSize value,
+    vk::DeviceSize alignment) -> vk::DeviceSize
+{
+    return (value + alignment - 1u) & ~(alignment - 1u);
+}
+
+} // namespace
+
+TransientRing::TransientRing(
+    Device        &device,
+    Allocator     &allocator_,
+    vk::DeviceSize capacity)
+    : allocator{allocator_.handle()}
+{
+    buffer = allocator_.createBuffer(
+        alignUp(std::max<vk::DeviceSize>(capacity, 1u), kMaxAlignment),
+        vk::BufferUsageFlagBits2::eUniformBuffer
+            | vk::BufferUsageFlagBits2::eStorageBuffer
+            | vk::BufferUsageFlagBits2::eVertexBuffer
+            | vk::BufferUsageFlagBits2::eIndexBuffer
+            | vk::BufferUsageFlagBits2::eIndirectBuffer,
+        false,
+        VMA_MEMORY_USAGE_AUTO,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+            | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+    VmaAllocationInfo allocationInfo{};
+    vmaGetAllocationInfo(allocator, buffer.allocation, &allocationInfo);
+
+    mapped = static_cast<std::byte *>(allocationInfo.pMappedData);
+
+    if (mapped == nullptr) {
+        throw std::runtime_error("TransientRing: buffer is not host mapped");
+    }
+
+    address = device.handle.getBufferAddress(vk::BufferDeviceAddressInfo{buffer.buffer});
+}
+
+auto TransientRing::allocate(
+    vk::DeviceSize size,
+    vk::DeviceSize alignment) -> TransientAllocation
+{
+    if (!std::has_single_bit(alignment) || alignment > kMaxAlignment) {
+        throw std::invalid_argument("TransientRing: bad alignment");
+    }
+
+    const vk::DeviceSize ringCapacity = capacity();
+
+    vk::DeviceSize position = alignUp(head, alignment);
+    vk::DeviceSize offset   = position % ringCapacity;
+
+    // never straddle the end: skip to the start of the next lap
+    if (offset + size > ringCapacity) {
+        position += ringCapacity - offset;
+        offset = 0u;
+    }
+
+    if (position + size - tail > ringCapacity) {
+        throw std::runtime_error("TransientRing: out of space");
+    }
+
+    head = position + size;
+
+    return TransientAllocation{
+        .buffer  = buffer.buffer,
+        .offset  = offset,
+        .size    = size,
+        .address = address + offset,
+        .mapped  = mapped + offset,
+    };
+}
+
+auto TransientRing::closeFrame(uint64_t timelineValue) -> void
+{
+    frameMarks.push_back(FrameMark{.timelineValue = timelineValue, .head = head});
+
+    const vk::DeviceSize written = head - std::exchange(closedHead, head);
+
+    if (written == 0u) {
+        return;
+    }
+
+    // only this frame's bytes, split where they wrap; VMA rounds to
+    // nonCoherentAtomSize and skips host-coherent memory
+    const vk::DeviceSize ringCapacity = capacity();
+
+    if (written >= ringCapacity) {
+        VK_CHECK(vmaFlushAllocation(allocator, buffer.allocation, 0, vk::WholeSize));
+        return;
+    }
+
+    const vk::DeviceSize begin = (head - written) % ringCapacity;
+    const vk::DeviceSize end   = begin + written;
+
+    if (end <= ringCapacity) {
+        VK_CHECK(vmaFlushAllocation(allocator, buffer.allocation, begin, written));
+    } else {
+        VK_CHECK(vmaFlushAllocation(
+            allocator,
+            buffer.allocation,
+            begin,
+            ringCapacity - begin));
+        VK_CHECK(vmaFlushAllocation(
+            allocator,
+            buffer.allocation,
+            0,
+            end - ringCapacity));
+    }
+}
+
+auto TransientRing::reclaim(uint64_t completedTimelineValue) -> void
+{
+    while (!frameMarks.empty()
+           && frameMarks.front().timelineValue <= completedTimelineValue) {
+        tail = frameMarks.front().head;
+        frameMarks.pop_front();
+    }
+}
@@ -0,0 +1,427 @@
+#include "UploadQueue.hpp"
+
+#include "Allocator.hpp"
+#include "Sync.hpp"
+#include "Utility.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+
+// covers the 4-byte and texel-block alignment of buffer-image copy offsets
+constexpr vk::DeviceSize kStagingAlignment = 16u;
+
+// everything that reads an uploaded buffer: geometry, indirect commands,
+// uniforms and storage buffers in the graphics and cull pipelines
+constexpr vk::PipelineStageFlags2 kBufferConsumerStages =
+    vk::PipelineStageFlagBits2::eVertexAttributeInput
+    | vk::PipelineStageFlagBits2::eIndexInput
+    | vk::PipelineStageFlagBits2::eDrawIndirect
+    | vk::PipelineStageFlagBits2::eVertexShader
+    | vk::PipelineStageFlagBits2::eFragmentShader
+    | vk::PipelineStageFlagBits2::eComputeShader;
+
+constexpr vk::AccessFlags2 kBufferConsumerAccess =
+    vk::AccessFlagBits2::eVertexAttributeRead | vk::AccessFlagBits2::eIndexRead
+    | vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eUniformRead
+    | vk::AccessFlagBits2::eShaderStorageRead;
+
+constexpr vk::PipelineStageFlags2 kImageConsumerStages =
+    vk::PipelineStageFlagBits2::eFragmentShader
+    | vk::PipelineStageFlagBits2::eComputeShader;
+
+auto createTimelineSemaphore(Device &device) -> vk::raii::Semaphore
+{
+    vk::SemaphoreTypeCreateInfo timelineInfo{vk::SemaphoreType::eTimeline, 0u};
+
+    return vk::raii::Semaphore{
+        device.handle,
+        vk::SemaphoreCreateInfo{{}, &timelineInfo}};
+}
+
+[[nodiscard]]
+auto alignUp(
+    vk::DeviceSize value,
+    vk::DeviceSize alignment) -> vk::DeviceSize
+{
+    return (value + alignment - 1u) / alignment * alignment;
+}
+
+[[nodiscard]]
+auto divideRoundUp(
+    uint32_t value,
+    uint32_t divisor) -> uint32_t
+{
+    return (value + divisor - 1u) / divisor;
+}
+
+} // namespace
+
+UploadQueue::UploadQueue(
+    const PhysicalDevice &physicalDevice,
+    Device               &device_,
+    Allocator            &allocator,
+    vk::DeviceSize        stagingCapacity)
+    : device{device_},
+      srcFamily{device_.queueFamilyIndices.transferIndex},
+      dstFamily{device_.queueFamilyIndices.graphicsIndex},
+      imageGranularity{
+          physicalDevice.handle.getQueueFamilyProperties()[srcFamily]
+              .minImageTransferGranularity},
+      pool{
+          device_.handle,
+          vk::CommandPoolCreateInfo{
+              vk::CommandPoolCreateFlagBits::eTransient,
+              device_.queueFamilyIndices.transferIndex}},
+      timelineSemaphore{createTimelineSemaphore(device_)},
+      vmaAllocator{allocator.handle()}
+{
+    stagingBuffer = allocator.createBuffer(
+        alignUp(std::max<vk::DeviceSize>(stagingCapacity, 1u), kStagingAlignment),
+        vk::BufferUsageFlagBits2::eTransferSrc,
+        true,
+        VMA_MEMORY_USAGE_AUTO,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+            | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+    VmaAllocationInfo allocationInfo{};
+    vmaGetAllocationInfo(vmaAllocator, stagingBuffer.allocation, &allocationInfo);
+
+    stagingMapped = static_cast<std::byte *>(allocationInfo.pMappedData);
+
+    if (stagingMapped == nullptr) {
+        throw std::runtime_error("UploadQueue: staging buffer is not host mapped");
+    }
+}
+
+UploadQueue::~UploadQueue()
+{
+    // command buffers must not be freed while pending; the staging buffer is
+    // released with the allocator
+    wait(submittedValue);
+}
+
+auto UploadQueue::cmd() -> vk::raii::CommandBuffer &
+{
+    if (!openBatch) {
+        openBatch.emplace();
+
+        openBatch->cmd = std::move(
+            vk::raii::CommandBuffers{
+                device.handle,
+                vk::CommandBufferAllocateInfo{pool, vk::CommandBufferLevel::ePrimary, 1}}
+                .front());
+
+        openBatch->cmd.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    }
+
+    return openBatch->cmd;
+}
+
+auto UploadQueue::reserveStaging(
+    vk::DeviceSize minSize,
+    vk::DeviceSize maxSize,
+    vk::DeviceSize unit,
+    vk::DeviceSize alignment) -> StagingChunk
+{
+    const vk::DeviceSize capacity = stagingBuffer.size;
+
+    if (minSize > capacity) {
+        throw std::runtime_error("UploadQueue: upload chunk larger than the staging ring");
+    }
+
+    for (;;) {
+        vk::DeviceSize position = alignUp(stagingHead, alignment);
+        vk::DeviceSize offset   = position % capacity;
+
+        // never straddle the end: skip to the start of the next lap
+        if (capacity - offset < minSize) {
+            position += capacity - offset;
+            offset = 0u;
+        }
+
+        const vk::DeviceSize used      = position - stagingTail;
+        const vk::DeviceSize available = used < capacity ? capacity - used : 0u;
+
+        vk::DeviceSize size = std::min({maxSize, capacity - offset, available});
+        size -= size % unit;
+
+        if (size >= minSize) {
+            stagingHead = position + size;
+            return StagingChunk{.offset = offset, .size = size};
+        }
+
+        // make room: retire the oldest batch, or submit the open one so it
+        // can be retired
+        if (!inFlight.empty()) {
+            wait(inFlight.front().timelineValue);
+            collect();
+        } else if (openBatch && stagingHead != submittedHead) {
+            submit();
+        } else {
+            // nothing left to retire, the ring is empty
+            stagingHead = stagingTail = submittedHead = alignUp(stagingHead, capacity);
+        }
+    }
+}
+
+auto UploadQueue::flushStaging(const StagingChunk &chunk) const -> void
+{
+    // no-op on host-coherent memory
+    VK_CHECK(vmaFlushAllocation(
+        vmaAllocator,
+        stagingBuffer.allocation,
+        chunk.offset,
+        chunk.size));
+}
+
+auto UploadQueue::uploadBuffer(
+    std::span<const std::byte> data,
+    vk::Buffer                 dst,
+    vk::DeviceSize             dstOffset) -> void
+{
+    vk::DeviceSize copied = 0u;
+
+    while (copied < data.size()) {
+        const vk::DeviceSize remaining = data.size() - copied;
+
+        const StagingChunk chunk = reserveStaging(
+            std::min(remaining, kStagingAlignment),
+            remaining,
+            1u,
+            kStagingAlignment);
+
+        std::memcpy(stagingMapped + chunk.offset, data.data() + copied, chunk.size);
+        flushStaging(chunk);
+
+        cmd().copyBuffer(
+            stagingBuffer.buffer,
+            dst,
+            vk::BufferCopy{chunk.offset, dstOffset + copied, chunk.size});
+
+        copied += chunk.size;
+    }
+}
+
+auto UploadQueue::uploadImage(
+    std::span<const std::byte> data,
+    vk::Image                  dst,
+    vk::ImageSubresourceLayers subresource,
+    vk::Extent2D               extent,
+    uint32_t                   bytesPerBlock,
+    vk::Extent2D               blockExtent) -> void
+{
+    const uint32_t blockColumns = divideRoundUp(extent.width, blockExtent.width);
+    const uint32_t blockRows    = divideRoundUp(extent.height, blockExtent.height);
+
+    const vk::DeviceSize rowBytes = vk::DeviceSize{blockColumns} * bytesPerBlock;
+
+    if (data.size() < rowBytes * blockRows) {
+        throw std::invalid_argument("UploadQueue: image data smaller than its extent");
+    }
+
+    // partial copies must start on granularity rows; a zero granularity
+    // allows whole subresources only
+    const uint32_t rowStep = imageGranularity.height == 0u
+                               ? blockRows
+                               : std::min(imageGranularity.height, blockRows);
+
+    const vk::DeviceSize alignment =
+        std::lcm(kStagingAlignment, vk::DeviceSize{bytesPerBlock});
+
+    uint32_t row = 0u;
+
+    while (row < blockRows) {
+        const uint32_t       remainingRows = blockRows - row;
+        const vk::DeviceSize minSize = rowBytes * std::min(rowStep, remainingRows);
+
+        const StagingChunk chunk = reserveStaging(
+            minSize,
+            rowBytes * remainingRows,
+            remainingRows <= rowStep ? minSize : rowBytes * rowStep,
+            alignment);
+
+        const auto rows = static_cast<uint32_t>(chunk.size / rowBytes);
+
+        std::memcpy(stagingMapped + chunk.offset, data.data() + row * rowBytes, chunk.size);
+        flushStaging(chunk);
+
+        const uint32_t y      = row * blockExtent.height;
+        const uint32_t height = std::min(rows * blockExtent.height, extent.height - y);
+
+        cmd().copyBufferToImage(
+            stagingBuffer.buffer,
+            dst,
+            vk::ImageLayout::eTransferDstOptimal,
+            vk::BufferImageCopy{
+                chunk.offset,
+                0u,
+                0u,
+                subresource,
+                vk::Offset3D{0, static_cast<int32_t>(y), 0},
+                vk::Extent3D{extent.width, height, 1u}});
+
+        row += rows;
+    }
+}
+
+auto UploadQueue::releaseBuffer(vk::Buffer buffer) -> void
+{
+    if (!dedicatedFamily()) {
+        cmd().pipelineBarrier2(
+            vk::DependencyInfo{}.setMemoryBarriers(
+                vk::MemoryBarrier2{
+                    vk::PipelineStageFlagBits2::eTransfer,
+                    vk::AccessFlagBits2::eTransferWrite,
+                    kBufferConsumerStages,
+                    kBufferConsumerAccess}));
+        return;
+    }
+
+    // release: the destination scope is ignored, the acquire provides it
+    cmd().pipelineBarrier2(
+        vk::DependencyInfo{}.setBufferMemoryBarriers(
+            vk::BufferMemoryBarrier2{
+                vk::PipelineStageFlagBits2::eTransfer,
+                vk::AccessFlagBits2::eTransferWrite,
+                vk::PipelineStageFlagBits2::eNone,
+                vk::AccessFlagBits2::eNone,
+                srcFamily,
+                dstFamily,
+                buffer,
+                0u,
+                vk::WholeSize}));
+
+    openAcquires.buffers.push_back(
+        vk::BufferMemoryBarrier2{
+            vk::PipelineStageFlagBits2::eNone,
+            vk::AccessFlagBits2::eNone,
+            kBufferConsumerStages,
+            kBufferConsumerAccess,
+            srcFamily,
+            dstFamily,
+            buffer,
+            0u,
+            vk::WholeSize});
+}
+
+auto UploadQueue::releaseImage(
+    vk::Image                 image,
+    vk::ImageSubresourceRange range) -> void
+{
+    if (!dedicatedFamily()) {
+        cmdBarrierTransferDstToShaderReadOnly(cmd(), image, range);
+        return;
+    }
+
+    // the layout transition happens once, between release and acquire
+    cmd().pipelineBarrier2(
+        vk::DependencyInfo{}.setImageMemoryBarriers(
+            vk::ImageMemoryBarrier2{
+                vk::PipelineStageFlagBits2::eTransfer,
+                vk::AccessFlagBits2::eTransferWrite,
+                vk::PipelineStageFlagBits2::eNone,
+                vk::AccessFlagBits2::eNone,
+                vk::ImageLayout::eTransferDstOptimal,
+                vk::ImageLayout::eShaderReadOnlyOptimal,
+                srcFamily,
+                dstFamily,
+                image,
+                range}));
+
+    openAcquires.images.push_back(
+        vk::ImageMemoryBarrier2{
+            vk::PipelineStageFlagBits2::eNone,
+            vk::AccessFlagBits2::eNone,
+            kImageConsumerStages,
+            vk::AccessFlagBits2::eShaderSampledRead,
+            vk::ImageLayout::eTransferDstOptimal,
+            vk::ImageLayout::eShaderReadOnlyOptimal,
+            srcFamily,
+            dstFamily,
+            image,
+            range});
+}
+
+auto UploadQueue::submit() -> uint64_t
+{
+    if (!openBatch) {
+        return submittedValue;
+    }
+
+    openBatch->cmd.end();
+
+    openBatch->timelineValue = ++submittedValue;
+    openBatch->stagingHead   = stagingHead;
+    submittedHead            = stagingHead;
+
+    const auto commandBufferSubmitInfo = vk::CommandBufferSubmitInfo{openBatch->cmd};
+    const auto signalSemaphoreSubmitInfo = vk::SemaphoreSubmitInfo{
+        timelineSemaphore,
+        openBatch->timelineValue,
+        vk::PipelineStageFlagBits2::eAllCommands};
+
+    device.transferQueue.submit2(
+        vk::SubmitInfo2{{}, {}, commandBufferSubmitInfo, signalSemaphoreSubmitInfo});
+
+    inFlight.push_back(std::move(*openBatch));
+    openBatch.reset();
+
+    pendingAcquires.buffers.append_range(openAcquires.buffers);
+    pendingAcquires.images.append_range(openAcquires.images);
+    openAcquires = Acquires{};
+
+    return submittedValue;
+}
+
+auto UploadQueue::collect() -> void
+{
+    const uint64_t completedValue = timelineSemaphore.getCounterValue();
+
+    while (!inFlight.empty() && inFlight.front().timelineValue <= completedValue) {
+        stagingTail = inFlight.front().stagingHead;
+        inFlight.pop_front();
+    }
+}
+
+auto UploadQueue::wait(uint64_t timelineValue) const -> void
+{
+    if (timelineValue == 0u) {
+        return;
+    }
+
+    [[maybe_unused]]
+    auto waitResult = device.handle.waitSemaphores(
+        vk::SemaphoreWaitInfo{{}, *timelineSemaphore, timelineValue},
+        std::numeric_limits<uint64_t>::max());
+}
+
+auto UploadQueue::recordAcquires(const vk::raii::CommandBuffer &cmd)
+    -> std::optional<vk::SemaphoreSubmitInfo>
+{
+    if (acquiredValue == submittedValue) {
+        return std::nullopt;
+    }
+
+    if (!pendingAcquires.buffers.empty() || !pendingAcquires.images.empty()) {
+        cmd.pipelineBarrier2(
+            vk::DependencyInfo{}
+                .setBufferMemoryBarriers(pendingAcquires.buffers)
+                .setImageMemoryBarriers(pendingAcquires.images));
+
+        pendingAcquires = Acquires{};
+    }
+
+    acquiredValue = submittedValue;
+
+    return vk::SemaphoreSubmitInfo{
+        timelineSemaphore,
+        acquiredValue,
+        vk::PipelineStageFlagBits2::eAllCommands};
+}
@@ -1,5 +1,10 @@
 #include "Utility.hpp"
 
+#include <algorithm>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+
 auto findDepthFormat(vk::raii::PhysicalDevice &physicalDevice) -> vk::Format
 {
     auto candidateFormats = std::array{
@@ -27,3 +32,67 @@ auto findDepthFormat(vk::raii::PhysicalDevice &physicalDevice) -> vk::Format
 
     return vk::Format::eUndefined;
 }
+
+auto queryTextureFormatSupport(vk::raii::PhysicalDevice &physicalDevice)
+    -> TextureFormatSupport
+{
+    constexpr auto requiredFeatures = vk::FormatFeatureFlagBits::eSampledImage
+                                    | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+
+    const auto sampleable = [&](std::initializer_list<vk::Format> formats) {
+        return std::ranges::all_of(formats, [&](vk::Format format) {
+            const auto features =
+                physicalDevice.getFormatProperties(format).optimalTilingFeatures;
+
+            return (features & requiredFeatures) == requiredFeatures;
+        });
+    };
+
+    // the device enables every supported core feature, textureCompressionBC
+    // included; without it no BC format may be used whatever the format
+    // properties say
+    if (!physicalDevice.getFeatures().textureCompressionBC) {
+        return TextureFormatSupport{};
+    }
+
+    // the sRGB twins are sampled through views of the UNORM storage
+    return TextureFormatSupport{
+        .bc1 = sampleable(
+            {vk::Format::eBc1RgbUnormBlock,
+             vk::Format::eBc1RgbSrgbBlock,
+             vk::Format::eBc1RgbaUnormBlock,
+             vk::Format::eBc1RgbaSrgbBlock}),
+        .bc3 = sampleable({vk::Format::eBc3UnormBlock, vk::Format::eBc3SrgbBlock}),
+        .bc4 = sampleable({vk::Format::eBc4UnormBlock}),
+        .bc5 = sampleable({vk::Format::eBc5UnormBlock}),
+        .bc7 = sampleable({vk::Format::eBc7UnormBlock, vk::Format::eBc7SrgbBlock}),
+    };
+}
+
+auto writeFileAtomically(
+    const std::filesystem::path                       &path,
+    std::initializer_list<std::span<const std::byte>> chunks) -> void
+{
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+
+    {
+        std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+
+        if (!file) {
+            throw std::runtime_error("cannot create " + temporaryPath.string());
+        }
+
+        for (const auto chunk : chunks) {
+            file.write(
+                reinterpret_cast<const char *>(chunk.data()),
+                static_cast<std::streamsize>(chunk.size()));
+        }
+
+        if (!file) {
+            throw std::runtime_error("cannot write " + temporaryPath.string());
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, path);
+}
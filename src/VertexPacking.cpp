@@ -0,0 +1,142 @@
+#include "VertexPacking.hpp"
+#include "Geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include <glm/gtc/packing.hpp>
+
+namespace
+{
+
+constexpr float kSnorm16Max = 32767.0f;
+
+[[nodiscard]]
+auto toSnorm16(float value) -> std::int16_t
+{
+    return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * kSnorm16Max));
+}
+
+[[nodiscard]]
+auto fromSnorm16(std::int16_t value) -> float
+{
+    return std::max(static_cast<float>(value) / kSnorm16Max, -1.0f);
+}
+
+[[nodiscard]]
+auto signNotZero(float value) -> float
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+[[nodiscard]]
+auto octahedralEncode(glm::vec3 normal) -> glm::vec2
+{
+    normal /= std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+
+    glm::vec2 encoded{normal.x, normal.y};
+
+    // fold the lower hemisphere over the diagonals
+    if (normal.z < 0.0f) {
+        encoded = glm::vec2{
+            (1.0f - std::abs(normal.y)) * signNotZero(normal.x),
+            (1.0f - std::abs(normal.x)) * signNotZero(normal.y)};
+    }
+
+    return encoded;
+}
+
+[[nodiscard]]
+auto octahedralDecode(glm::vec2 encoded) -> glm::vec3
+{
+    glm::vec3 normal{encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y)};
+
+    const float fold = std::max(-normal.z, 0.0f);
+
+    normal.x += normal.x >= 0.0f ? -fold : fold;
+    normal.y += normal.y >= 0.0f ? -fold : fold;
+
+    return glm::normalize(normal);
+}
+
+// Duff et al., "Building an Orthonormal Basis, Revisited". The shader
+// builds the same basis from the decoded normal.
+auto orthonormalBasis(
+    glm::vec3  normal,
+    glm::vec3 &b1,
+    glm::vec3 &b2) -> void
+{
+    const float sign = normal.z >= 0.0f ? 1.0f : -1.0f;
+    const float a    = -1.0f / (sign + normal.z);
+    const float b    = normal.x * normal.y * a;
+
+    b1 = glm::vec3{1.0f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x};
+    b2 = glm::vec3{b, sign + normal.y * normal.y * a, -normal.y};
+}
+
+} // namespace
+
+auto packNormalTangent(
+    glm::vec3                normal,
+    std::optional<glm::vec4> tangent) -> std::array<std::int16_t, 4>
+{
+    if (glm::dot(normal, normal) < 1e-12f) {
+        return kPackedNoNormal;
+    }
+
+    const glm::vec2 encoded = octahedralEncode(normal);
+
+    std::array<std::int16_t, 4> packed{toSnorm16(encoded.x), toSnorm16(encoded.y), 0, 0};
+
+    if (!tangent.has_value()) {
+        return packed;
+    }
+
+    // measure the angle against the normal the GPU will see
+    const glm::vec3 decoded = unpackNormal(packed);
+
+    glm::vec3 b1{};
+    glm::vec3 b2{};
+    orthonormalBasis(decoded, b1, b2);
+
+    const glm::vec3 projected =
+        glm::vec3{*tangent} - decoded * glm::dot(decoded, glm::vec3{*tangent});
+
+    if (glm::dot(projected, projected) < 1e-12f) {
+        return packed;
+    }
+
+    const float angle = std::atan2(glm::dot(projected, b2), glm::dot(projected, b1));
+
+    packed[2] = toSnorm16(angle / std::numbers::pi_v<float>);
+    packed[3] = toSnorm16(signNotZero(tangent->w));
+
+    return packed;
+}
+
+auto unpackNormal(const std::array<std::int16_t, 4> &normalTangent) -> glm::vec3
+{
+    return octahedralDecode(
+        glm::vec2{fromSnorm16(normalTangent[0]), fromSnorm16(normalTangent[1])});
+}
+
+auto packHalf2(glm::vec2 value) -> std::uint32_t
+{
+    return glm::packHalf2x16(value);
+}
+
+auto packUnorm2x16(glm::vec2 value) -> std::uint32_t
+{
+    return glm::packUnorm2x16(value);
+}
+
+auto packSnorm2x16(glm::vec2 value) -> std::uint32_t
+{
+    return glm::packSnorm2x16(value);
+}
+
+auto packUnorm4(glm::vec4 value) -> std::uint32_t
+{
+    return glm::packUnorm4x8(value);
+}
@@ -1,6 +1,7 @@
 #include "AABB.hpp"
 #include "Camera.hpp"
 #include "GltfLoader.hpp"
+#include "NodeInstanceStore.hpp"
 #include "RenderContext.hpp"
 #include "RenderableResources.hpp"
 #include "Renderer.hpp"
@@ -43,33 +44,26 @@ auto chooseSurfaceFormat(const std::vector<vk::SurfaceFormatKHR> &availableForma
     return availableFormats.front();
 }
 
+// Returns the node instance bytes uploaded; only instances that changed since
+// this frame slot was last uploaded are copied.
 auto updatePerFrameUniformBuffers(
-    const Allocator                     &allocator,
-    Buffer                              &frameUBO,
-    Buffer                              &nodeInstancesSSBO,
-    const FrameUniforms                 &frame,
-    const std::vector<NodeInstanceData> &nodeInstances) -> void
+    const Allocator     &allocator,
+    Renderer            &renderer,
+    const FrameUniforms &frame,
+    NodeInstanceStore   &nodeInstances) -> vk::DeviceSize
 {
     VK_CHECK(vmaCopyMemoryToAllocation(
         allocator.handle(),
         &frame,
-        frameUBO.allocation,
+        renderer.currentFrameUBO().allocation,
         0,
         sizeof(FrameUniforms)));
 
-    if (nodeInstances.empty()) {
-        return;
-    }
-
-    const auto bytes = static_cast<vk::DeviceSize>(sizeof(NodeInstanceData))
-                     * static_cast<vk::DeviceSize>(nodeInstances.size());
-
-    VK_CHECK(vmaCopyMemoryToAllocation(
-        allocator.handle(),
-        nodeInstances.data(),
-        nodeInstancesSSBO.allocation,
-        0,
-        bytes));
+    return nodeInstances.upload(
+        allocator,
+        renderer.currentFrameIndex(),
+        renderer.currentNodeInstancesSSBO(),
+        renderer.uniformBuffersGeneration());
 }
 
 namespace
@@ -172,7 +166,6 @@ auto main(
     auto requiredExtensions = std::vector{
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME,
-        // VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
         VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME,
         VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME,
         VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME,
@@ -184,14 +177,26 @@ auto main(
         VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
         VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME};
 
-    auto context = RenderContext{window, requiredExtensions};
+    auto optionalExtensions = std::vector{VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME};
+
+    // upper bound for upload staging memory, whatever the asset size
+    constexpr vk::DeviceSize kStagingMegabytes = 32u;
+
+    auto context = RenderContext{
+        window,
+        requiredExtensions,
+        optionalExtensions,
+        shaderPath.parent_path() / "pipeline.cache",
+        kStagingMegabytes << 20u};
 
     const auto colorFormat = context.colorFormat();
     const auto depthFormat = context.depthFormat();
 
-    Command uploadCmd{context.device, vk::CommandPoolCreateFlagBits::eTransient};
+    // decoded and transcoded textures must be sampleable on this device
+    const AssetLoadOptions assetLoadOptions{
+        .textureFormats = queryTextureFormatSupport(context.physicalDevice.handle)};
 
-    auto asset         = getAsset(gltfPath);
+    auto asset         = getAsset(gltfPath, assetLoadOptions);
     auto sceneDrawList = buildSceneView(asset);
 
     auto textureCount = static_cast<uint32_t>(asset.textures.size());
@@ -227,11 +232,25 @@ auto main(
              vk::DescriptorType::eSampler,
              textureCount,
              vk::ShaderStageFlagBits::eFragment},
+
+            {kBindingDrawData,
+             vk::DescriptorType::eStorageBuffer,
+             1,
+             vk::ShaderStageFlagBits::eVertex},
         }},
         .shaderPath                 = shaderPath,
         .colorFormat                = colorFormat,
         .depthFormat                = depthFormat,
         .maxFramesInFlight          = 2,
+        .drawSubmission             = DrawSubmission::Indirect,
+        .gpuFrustumCulling          = true,
+        .cullShaderPath = shaderPath.parent_path() / "frustum_cull.slang.spv",
+        .gpuOcclusionCulling = true,
+        .depthPyramidShaderPath =
+            shaderPath.parent_path() / "depth_pyramid.slang.spv",
+        .cpuFrustumCulling = true,
+        .drawSorting       = true,
+        .descriptorBuffer  = true,
     };
     auto renderer = Renderer{context, rendererConfig};
 
@@ -242,7 +261,13 @@ auto main(
     upsertDefaultCameraInstance(asset, sceneDrawList, initialViewportAspect);
     auto renderableResources = RenderableResources{};
     renderableResources
-        .create(asset, sceneDrawList, context.device, uploadCmd, context.allocator);
+        .create(
+            asset,
+            sceneDrawList,
+            context.device,
+            context.uploadQueue,
+            context.hostImageCopy,
+            context.allocator);
 
     auto nodeInstancesData = std::vector<NodeInstanceData>{};
     nodeInstancesData.reserve(sceneDrawList.nodeInstances.size());
@@ -254,14 +279,24 @@ auto main(
             });
     }
 
-    const uint32_t nodeInstanceCount = static_cast<uint32_t>(nodeInstancesData.size());
-    renderer.initializePerFrameUniformBuffers(context.allocator, nodeInstanceCount);
+    auto nodeInstances = NodeInstanceStore{
+        std::move(nodeInstancesData),
+        rendererConfig.maxFramesInFlight};
+
+    renderer.initializePerFrameUniformBuffers(context.allocator, nodeInstances.size());
+    renderer.initializePerFrameCullBuffers(
+        context.allocator,
+        renderableResources.indirectDrawCount);
 
     auto     running        = true;
     auto     previousTime   = std::chrono::high_resolution_clock::now();
     auto     cumulativeTime = previousTime - previousTime;
     uint64_t frameCount     = 0;
 
+    auto cullStats = CullStats{};
+
+    vk::DeviceSize nodeInstanceUploadBytes = 0u;
+
     SDL_Event e;
     while (running) {
         while (SDL_PollEvent(&e)) {
@@ -291,8 +326,22 @@ auto main(
             auto fps = frameCount * 1000000000UL / cumulativeTime.count();
             fmt::println(stderr, "{} FPS ({:.2} ms)", fps, 1000.0 / fps);
 
+            if (cullStats.tested > 0u) {
+                fmt::println(
+                    stderr,
+                    "CPU culling: {} tested, {} culled",
+                    cullStats.tested,
+                    cullStats.culled);
+            }
+
+            fmt::println(
+                stderr,
+                "node instance uploads: {} bytes/frame",
+                nodeInstanceUploadBytes / frameCount);
+
             cumulativeTime -= 3s;
-            frameCount = 0;
+            frameCount              = 0;
+            nodeInstanceUploadBytes = 0u;
         }
 
         const auto extent = context.extent();
@@ -303,27 +352,35 @@ auto main(
 
         const auto &activeCamera = asset.cameras[activeCameraInstance.cameraIndex];
 
+        const auto viewMatrix = activeCamera.getViewMatrix(
+            activeCameraInstance.translation,
+            activeCameraInstance.rotation);
+
         auto frameUniforms = FrameUniforms{
-            .viewProjectionMatrix = activeCamera.getProjectionMatrix(viewportAspect)
-                                  * activeCamera.getViewMatrix(
-                                      activeCameraInstance.translation,
-                                      activeCameraInstance.rotation),
+            .viewProjectionMatrix =
+                activeCamera.getProjectionMatrix(viewportAspect) * viewMatrix,
             .directionalLight = DirectionalLight{},
             .pointLight       = PointLight{},
         };
 
-        updatePerFrameUniformBuffers(
+        nodeInstanceUploadBytes += updatePerFrameUniformBuffers(
             context.allocator,
-            renderer.currentFrameUBO(),
-            renderer.currentNodeInstancesSSBO(),
+            renderer,
             frameUniforms,
-            nodeInstancesData);
+            nodeInstances);
 
-        renderableResources.updateDescriptorSet(
-            context.device,
-            renderer.currentDescriptorSet(),
-            renderer.currentFrameUBO(),
-            renderer.currentNodeInstancesSSBO());
+        renderer.updateDescriptorSet(renderableResources);
+
+        // CPU culling and draw sorting use the current bounds of moved
+        // instances
+        renderableResources.updateWorldBounds(
+            nodeInstances.data(),
+            nodeInstances.takeChangedInstances());
+
+        cullStats =
+            renderer.cullDraws(renderableResources, frameUniforms.viewProjectionMatrix);
+
+        renderer.sortDraws(renderableResources, viewMatrix);
 
         renderer.render(renderableResources);
 
@@ -331,4 +388,6 @@ auto main(
     }
 
     context.device.graphicsQueue.waitIdle();
+
+    context.pipelineCache.save();
 }